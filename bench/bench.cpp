@@ -0,0 +1,618 @@
+// Benchmark suite: ImageProcessor kernels and evaluation of synthetic graph topologies.
+// Results are written as JSON so runs can be diffed against each other.
+// Exits non-zero if a kernel fails one of its correctness checks.
+// Usage: bench [--quick] [--filter <substring>] [--out <file>]
+#include "ConvolutionEngine.h"
+#include "DiskCache.h"
+#include "ImageLoader.h"
+#include "ImageProcessor.h"
+#include "SequencePipeline.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include "utils.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct BenchSettings {
+    bool quick = false;
+    std::string filter;
+    double minSeconds = 0.5;  // Time spent measuring each case
+    int minIterations = 5;
+    int maxIterations = 200;
+};
+
+struct BenchResult {
+    std::string name;
+    std::string group;
+    std::vector<std::pair<std::string, std::string>> params;
+    int iterations = 0;
+    double minMs = 0, medianMs = 0, meanMs = 0;
+    double megapixelsPerSecond = 0;  // Based on the median, 0 if not meaningful
+};
+
+static std::vector<BenchResult> results;
+static int failedChecks = 0; // Correctness checks that failed, makes the run exit non-zero
+
+// The evaluator logs every step to stdout, which would swamp the timings and the JSON
+struct QuietStdout {
+    QuietStdout() { std::cout.setstate(std::ios::failbit); }
+    ~QuietStdout() { std::cout.clear(); }
+};
+
+template <typename T>
+static std::string ToString(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+// Times body() after one warm-up call and records the result unless filtered out
+static void Measure(const BenchSettings& settings, const std::string& name, const std::string& group,
+                    std::vector<std::pair<std::string, std::string>> params, double pixels,
+                    const std::function<void()>& body) {
+    if (!settings.filter.empty() && name.find(settings.filter) == std::string::npos) return;
+
+    body();
+    std::vector<double> samples;
+    double total = 0;
+    while (static_cast<int>(samples.size()) < settings.maxIterations &&
+           (static_cast<int>(samples.size()) < settings.minIterations || total < settings.minSeconds * 1000.0)) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        samples.push_back(ms);
+        total += ms;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    BenchResult result;
+    result.name = name;
+    result.group = group;
+    result.params = std::move(params);
+    result.iterations = static_cast<int>(samples.size());
+    result.minMs = samples.front();
+    result.medianMs = samples[samples.size() / 2];
+    result.meanMs = total / samples.size();
+    result.megapixelsPerSecond = pixels > 0 ? pixels / (result.medianMs * 1000.0) : 0;
+    results.push_back(result);
+    std::cerr << name << ": " << result.medianMs << " ms" << std::endl;
+}
+
+static cv::Mat RandomImage(int size, int channels) {
+    cv::Mat image(size, size, CV_8UC(channels));
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+    return image;
+}
+
+// --- Kernels ---
+
+// A point-operation chain run node by node, as without fusion
+static cv::Mat ApplyPointOpsUnfused(const cv::Mat& image, const std::vector<PointOp>& ops) {
+    cv::Mat result = image;
+    for (const PointOp& op : ops) {
+        result = op.alpha == 1.0 ? ImageProcessor::applyBrightness(result, static_cast<int>(op.beta))
+                                 : ImageProcessor::applyContrast(result, op.alpha);
+    }
+    return result;
+}
+
+// The SIMD point operations must reproduce OpenCV; blend may differ by one
+// level where OpenCV fuses the multiply-add
+static void CheckAgainstOpenCV(const cv::Mat& image, const cv::Mat& other, const std::string& shape) {
+    cv::Mat expected, actual;
+    image.convertTo(expected, -1, 1, -37);
+    ImageProcessor::applyBrightness(image, actual, -37);
+    double brightnessDiff = cv::norm(expected, actual, cv::NORM_INF);
+    image.convertTo(expected, -1, 1.3, 0);
+    ImageProcessor::applyContrast(image, actual, 1.3);
+    double contrastDiff = cv::norm(expected, actual, cv::NORM_INF);
+    cv::addWeighted(image, 0.3, other, 0.7, 0, expected);
+    ImageProcessor::blend(image, other, actual, 0.3);
+    double blendDiff = cv::norm(expected, actual, cv::NORM_INF);
+    if (brightnessDiff != 0 || contrastDiff != 0 || blendDiff > 1) {
+        std::cerr << "Error: SIMD kernels differ from OpenCV for " << shape << " (brightness " << brightnessDiff
+                  << ", contrast " << contrastDiff << ", blend " << blendDiff << ")" << std::endl;
+        failedChecks++;
+    }
+}
+
+// Every SIMD level must give the scalar kernels' bytes, also where products
+// overflow the integer range or the factor is not finite
+static void CheckSimdAgainstScalar(const cv::Mat& image, const cv::Mat& other, const std::string& shape) {
+    const double factors[] = {1e30, 3e9, -3e9, std::numeric_limits<double>::infinity(),
+                              -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::quiet_NaN()};
+    for (double factor : factors) {
+        cv::Mat scalarContrast, scalarBlend, simdContrast, simdBlend;
+        SetSimdLevel(SimdLevel::Scalar);
+        ImageProcessor::applyContrast(image, scalarContrast, factor);
+        ImageProcessor::blend(image, other, scalarBlend, factor);
+        SetSimdLevel(DetectedSimdLevel());
+        ImageProcessor::applyContrast(image, simdContrast, factor);
+        ImageProcessor::blend(image, other, simdBlend, factor);
+        if (cv::norm(scalarContrast, simdContrast, cv::NORM_INF) != 0 || cv::norm(scalarBlend, simdBlend, cv::NORM_INF) != 0) {
+            std::cerr << "Error: SIMD kernels differ from the scalar ones for " << shape << " at factor " << factor << std::endl;
+            failedChecks++;
+        }
+    }
+}
+
+// The box cascade against the exact Gaussian on the hardest 8-bit content:
+// a step edge and checkerboards, whose edges show the cascade's tails most
+static void CheckFastBlurAccuracy(const BenchSettings& settings) {
+    if (!settings.filter.empty() && std::string("applyFastGaussianBlur").find(settings.filter) == std::string::npos) return;
+
+    const int size = 512;
+    std::vector<std::pair<std::string, cv::Mat>> patterns;
+    cv::Mat step(size, size, CV_8UC1, cv::Scalar(0));
+    step.colRange(size / 2, size).setTo(255);
+    patterns.push_back({"step", step});
+    for (int square : {8, 16, 32, 64}) {
+        cv::Mat checker(size, size, CV_8UC1);
+        for (int y = 0; y < size; y++) {
+            for (int x = 0; x < size; x++) checker.at<uchar>(y, x) = ((x / square + y / square) % 2) ? 255 : 0;
+        }
+        patterns.push_back({"checker" + ToString(square), checker});
+    }
+
+    std::vector<int> kernelSizes = settings.quick ? std::vector<int>{41, 151} : std::vector<int>{41, 75, 151, 301};
+    for (const auto& pattern : patterns) {
+        for (int kernelSize : kernelSizes) {
+            cv::Mat exact, approximate;
+            cv::GaussianBlur(pattern.second, exact, cv::Size(kernelSize, kernelSize), 0);
+            ImageProcessor::applyFastGaussianBlur(pattern.second, approximate, kernelSize);
+            double error = cv::norm(exact, approximate, cv::NORM_INF);
+            if (error > ImageProcessor::fastBlurMaxError) {
+                std::cerr << "Error: applyFastGaussianBlur is " << error << " levels off the exact Gaussian on "
+                          << pattern.first << " at k" << kernelSize << " (bound " << ImageProcessor::fastBlurMaxError << ")" << std::endl;
+                failedChecks++;
+            }
+        }
+    }
+}
+
+static void BenchKernels(const BenchSettings& settings) {
+    std::vector<int> sizes = settings.quick ? std::vector<int>{512} : std::vector<int>{256, 1024, 2048};
+    std::vector<int> channelCounts = {1, 3, 4};
+    std::vector<int> kernelSizes = settings.quick ? std::vector<int>{5, 75} : std::vector<int>{3, 9, 31, 75, 151};
+
+    for (int size : sizes) {
+        for (int channels : channelCounts) {
+            cv::Mat image = RandomImage(size, channels);
+            cv::Mat other = RandomImage(size, channels);
+            cv::Mat dst;
+            double pixels = static_cast<double>(size) * size;
+            std::string shape = ToString(size) + "x" + ToString(size) + "x" + ToString(channels);
+            std::vector<std::pair<std::string, std::string>> params = {{"size", ToString(size)}, {"channels", ToString(channels)}};
+
+            Measure(settings, "applyBrightness/" + shape, "kernel", params, pixels,
+                    [&]() { dst = ImageProcessor::applyBrightness(image, 20); });
+            Measure(settings, "applyBrightness_dst/" + shape, "kernel", params, pixels,
+                    [&]() { ImageProcessor::applyBrightness(image, dst, 20); });
+            Measure(settings, "applyContrast/" + shape, "kernel", params, pixels,
+                    [&]() { dst = ImageProcessor::applyContrast(image, 1.2); });
+            Measure(settings, "blend/" + shape, "kernel", params, pixels,
+                    [&]() { dst = ImageProcessor::blend(image, other, 0.3); });
+
+            // The SIMD kernels against the OpenCV calls they replace and their scalar fallback
+            Measure(settings, "applyBrightness_opencv/" + shape, "kernel", params, pixels,
+                    [&]() { image.convertTo(dst, -1, 1, 20); });
+            Measure(settings, "applyContrast_opencv/" + shape, "kernel", params, pixels,
+                    [&]() { image.convertTo(dst, -1, 1.2, 0); });
+            Measure(settings, "blend_opencv/" + shape, "kernel", params, pixels,
+                    [&]() { cv::addWeighted(image, 0.3, other, 0.7, 0, dst); });
+            Measure(settings, "applyNoise/" + shape, "kernel", params, pixels,
+                    [&]() { ImageProcessor::applyNoise(image, dst, 0.05, 1); });
+
+            SetSimdLevel(SimdLevel::Scalar);
+            Measure(settings, "applyBrightness_scalar/" + shape, "kernel", params, pixels,
+                    [&]() { ImageProcessor::applyBrightness(image, dst, 20); });
+            Measure(settings, "applyContrast_scalar/" + shape, "kernel", params, pixels,
+                    [&]() { ImageProcessor::applyContrast(image, dst, 1.2); });
+            Measure(settings, "blend_scalar/" + shape, "kernel", params, pixels,
+                    [&]() { ImageProcessor::blend(image, other, dst, 0.3); });
+            SetSimdLevel(DetectedSimdLevel());
+            CheckAgainstOpenCV(image, other, shape);
+            CheckSimdAgainstScalar(image, other, shape);
+
+            for (int kernelSize : kernelSizes) {
+                auto blurParams = params;
+                blurParams.push_back({"kernel", ToString(kernelSize)});
+                Measure(settings, "applyBlur/" + shape + "/k" + ToString(kernelSize), "kernel", blurParams, pixels,
+                        [&]() { dst = ImageProcessor::applyBlur(image, kernelSize); });
+                if (kernelSize < 31) continue;
+
+                // Constant-time box cascade against the exact Gaussian, with its error in 8-bit levels
+                cv::Mat exact, approximate;
+                cv::GaussianBlur(image, exact, cv::Size(kernelSize, kernelSize), 0);
+                ImageProcessor::applyFastGaussianBlur(image, approximate, kernelSize);
+                cv::Mat error;
+                cv::absdiff(exact, approximate, error);
+                auto fastParams = blurParams;
+                fastParams.push_back({"max_abs_error", ToString(cv::norm(error, cv::NORM_INF))});
+                fastParams.push_back({"mean_abs_error", ToString(cv::mean(error.reshape(1))[0])});
+                Measure(settings, "gaussianBlur_opencv/" + shape + "/k" + ToString(kernelSize), "kernel", blurParams, pixels,
+                        [&]() { cv::GaussianBlur(image, dst, cv::Size(kernelSize, kernelSize), 0); });
+                Measure(settings, "applyFastGaussianBlur/" + shape + "/k" + ToString(kernelSize), "kernel", fastParams, pixels,
+                        [&]() { ImageProcessor::applyFastGaussianBlur(image, dst, kernelSize); });
+            }
+
+            // Point-operation fusion: the fused LUT pass against running the chain node by node
+            std::vector<PointOp> ops;
+            for (int i = 0; i < 5; i++) ops.push_back(i % 2 == 0 ? PointOp::brightness(10 + i) : PointOp::contrast(1.1));
+            auto fusedParams = params;
+            fusedParams.push_back({"chain", ToString(ops.size())});
+            Measure(settings, "pointOps_unfused/" + shape, "kernel", fusedParams, pixels,
+                    [&]() { dst = ApplyPointOpsUnfused(image, ops); });
+            Measure(settings, "pointOps_fused/" + shape, "kernel", fusedParams, pixels,
+                    [&]() { dst = ImageProcessor::applyPointOps(image, ops); });
+
+            // Fused and unfused steps share cache keys, so they must agree to the byte,
+            // also for factors below 1 and ones that round differently in float and double
+            for (double factor : {0.05, 0.137, 0.5, 0.913, 1.1, 1.337, 2.05, 3.999}) {
+                std::vector<PointOp> chain = {PointOp::brightness(10), PointOp::contrast(factor),
+                                              PointOp::brightness(-7), PointOp::contrast(factor)};
+                if (cv::norm(ApplyPointOpsUnfused(image, chain), ImageProcessor::applyPointOps(image, chain), cv::NORM_INF) != 0) {
+                    std::cerr << "Error: fused point operations differ from the unfused chain for " << shape
+                              << " at contrast " << factor << std::endl;
+                    failedChecks++;
+                }
+            }
+        }
+    }
+}
+
+// Every convolution method on the same kernels, to check where the engine's
+// measured crossover lands. Each result records the method the engine would
+// pick and the largest difference from filter2D in 8-bit levels.
+static void BenchConvolution(const BenchSettings& settings) {
+    int size = settings.quick ? 512 : 1024;
+    std::vector<int> kernelSizes = settings.quick ? std::vector<int>{5, 25} : std::vector<int>{3, 5, 9, 15, 25, 41, 63};
+    cv::Mat image = RandomImage(size, 3);
+    cv::Mat dst, reference;
+    double pixels = static_cast<double>(size) * size;
+    std::string shape = ToString(size) + "x" + ToString(size) + "x3";
+
+    for (int kernelSize : kernelSizes) {
+        cv::Mat dense(kernelSize, kernelSize, CV_32F);
+        cv::randu(dense, cv::Scalar(0.0), cv::Scalar(1.0));
+        dense /= cv::sum(dense)[0];
+        cv::Mat gaussian1D = cv::getGaussianKernel(kernelSize, 0, CV_32F);
+        cv::Mat gaussian = gaussian1D * gaussian1D.t();
+
+        for (const auto& kernel : {std::make_pair(std::string("dense"), dense), std::make_pair(std::string("separable"), gaussian)}) {
+            cv::filter2D(image, reference, -1, kernel.second, cv::Point(-1, -1), 0, cv::BORDER_REFLECT_101);
+            std::vector<ConvolutionMethod> methods = {ConvolutionMethod::Direct, ConvolutionMethod::FFT};
+            if (kernel.first == "separable") methods.push_back(ConvolutionMethod::Separable);
+
+            for (ConvolutionMethod method : methods) {
+                Convolve(image, dst, kernel.second, method);
+                std::vector<std::pair<std::string, std::string>> params = {
+                    {"size", ToString(size)}, {"kernel", ToString(kernelSize)}, {"kernel_type", kernel.first},
+                    {"chosen", ConvolutionMethodName(ChooseConvolutionMethod(kernel.second))},
+                    {"max_abs_error", ToString(cv::norm(dst, reference, cv::NORM_INF))}};
+                Measure(settings, std::string("convolution_") + ConvolutionMethodName(method) + "/" + kernel.first + "/" + shape + "/k" + ToString(kernelSize),
+                        "kernel", params, pixels, [&]() { Convolve(image, dst, kernel.second, method); });
+            }
+        }
+    }
+}
+
+// --- Decoding ---
+
+// Full JPEG decode against the reduced decode previews use, on a photo-sized
+// file whose content compresses like a photo rather than like noise
+static void BenchDecode(const BenchSettings& settings) {
+    cv::Size size = settings.quick ? cv::Size(2000, 1500) : cv::Size(4000, 3000);
+    cv::Mat image(size, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::GaussianBlur(image, image, cv::Size(0, 0), 4.0);
+    std::string path = (std::filesystem::temp_directory_path() / "bench_decode.jpg").string();
+    if (!cv::imwrite(path, image)) {
+        std::cerr << "Error: Cannot write " << path << std::endl;
+        return;
+    }
+
+    double pixels = static_cast<double>(size.area());
+    std::string shape = ToString(size.width) + "x" + ToString(size.height);
+    Measure(settings, "decode_jpeg/full/" + shape, "decode", {{"width", ToString(size.width)}}, pixels,
+            [&]() { ImageLoader::Decode(path); });
+    for (int maxSize : {1024, 512}) {
+        int reduction = ImageLoader::Decode(path, maxSize).reduction;
+        Measure(settings, "decode_jpeg/preview" + ToString(maxSize) + "/" + shape, "decode",
+                {{"width", ToString(size.width)}, {"max_size", ToString(maxSize)}, {"reduction", ToString(reduction)}}, pixels,
+                [&]() { ImageLoader::Decode(path, maxSize); });
+    }
+    std::filesystem::remove(path);
+}
+
+// --- Graphs ---
+
+// Builds graphs the way the editor does: one output slot per node, links from output to input
+struct GraphBuilder {
+    NodeStore nodes;
+    std::vector<Link> links;
+    int nextSlot = 1000;
+
+    int AddSource(const cv::Mat& image) {
+        Node node;
+        node.id = static_cast<int>(nodes.size());
+        node.type = OperationType::LoadImage;
+        node.name = "Load Image";
+        node.outputSlotId = nextSlot++;
+        node.imagePath = "synthetic";
+        NodeHandle handle = nodes.Insert(node);
+        nodes.Images(*nodes.Get(handle)).loadedCvImage = image;
+        return node.id;
+    }
+
+    int AddOperation(OperationType type, float value, int inputNode) {
+        Node node;
+        node.id = static_cast<int>(nodes.size());
+        node.type = type;
+        node.name = "Operation";
+        node.inputSlotId = nextSlot++;
+        node.outputSlotId = nextSlot++;
+        node.value = value;
+        links.push_back({static_cast<int>(links.size()), nodes.FindById(inputNode)->outputSlotId, node.inputSlotId});
+        nodes.Insert(node);
+        return node.id;
+    }
+};
+
+// Mix of spatial and point operations, as a user building an edit would
+static int AddMixedOperation(GraphBuilder& graph, int index, int inputNode) {
+    switch (index % 3) {
+        case 0: return graph.AddOperation(OperationType::Blur, 5.0f, inputNode);
+        case 1: return graph.AddOperation(OperationType::Brightness, 10.0f, inputNode);
+        default: return graph.AddOperation(OperationType::Contrast, 1.05f, inputNode);
+    }
+}
+
+static void BenchGraph(const BenchSettings& settings, const std::string& topology, GraphBuilder& graph,
+                       const std::vector<int>& targets, int size) {
+    double pixels = static_cast<double>(size) * size * (graph.nodes.size() - 1);
+    for (int threads : {1, 0}) {
+        EvalOptions options;
+        options.maxConcurrency = threads;
+        std::string mode = threads == 1 ? "serial" : "parallel";
+        std::vector<std::pair<std::string, std::string>> params = {
+            {"topology", topology}, {"nodes", ToString(graph.nodes.size())}, {"size", ToString(size)}, {"mode", mode}};
+
+        // Cold: every node recomputes, as after loading a new image
+        Measure(settings, "graph/" + topology + "/" + mode + "/cold", "graph", params, pixels, [&]() {
+            QuietStdout quiet;
+            EvalCache cache;
+            std::vector<cv::Mat> outputs;
+            if (targets.size() == 1) outputs.push_back(ProcessGraph(targets[0], cache, graph.nodes, graph.links, options));
+            else ProcessGraphTargets(targets, cache, graph.nodes, graph.links, outputs, options);
+        });
+    }
+
+    // Warm: nothing changed, measures compilation and cache lookups alone
+    EvalCache cache;
+    std::vector<std::pair<std::string, std::string>> params = {
+        {"topology", topology}, {"nodes", ToString(graph.nodes.size())}, {"size", ToString(size)}, {"mode", "warm"}};
+    Measure(settings, "graph/" + topology + "/warm", "graph", params, 0, [&]() {
+        QuietStdout quiet;
+        std::vector<cv::Mat> outputs;
+        ProcessGraphTargets(targets, cache, graph.nodes, graph.links, outputs);
+    });
+
+    // Disk: fresh in-memory cache but a populated disk cache, as when a new
+    // session or batch run repeats earlier work; hits map the stored targets
+    std::string cacheDir = (std::filesystem::temp_directory_path() / ("bench_disk_cache_" + topology)).string();
+    {
+        DiskCache diskCache(cacheDir, uint64_t(1) << 30);
+        EvalOptions options;
+        options.diskCache = &diskCache;
+        params.back().second = "disk";
+        Measure(settings, "graph/" + topology + "/disk", "graph", params, pixels, [&]() {
+            QuietStdout quiet;
+            EvalCache freshCache;
+            std::vector<cv::Mat> outputs;
+            ProcessGraphTargets(targets, freshCache, graph.nodes, graph.links, outputs, options);
+        });
+        diskCache.Clear();
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(cacheDir, ec);
+}
+
+static void BenchGraphs(const BenchSettings& settings) {
+    int size = settings.quick ? 512 : 1024;
+    cv::Mat image = RandomImage(size, 3);
+    int chainLength = settings.quick ? 8 : 32;
+    int fanOut = settings.quick ? 4 : 16;
+    int depth = settings.quick ? 4 : 8;
+    int width = 4;
+
+    // Long chain: load -> op -> op -> ...
+    {
+        GraphBuilder graph;
+        int last = graph.AddSource(image);
+        for (int i = 0; i < chainLength; i++) last = AddMixedOperation(graph, i, last);
+        BenchGraph(settings, "chain" + ToString(chainLength), graph, {last}, size);
+    }
+
+    // Wide fan-out: one source feeding many independent blurs
+    {
+        GraphBuilder graph;
+        int source = graph.AddSource(image);
+        std::vector<int> targets;
+        for (int i = 0; i < fanOut; i++) {
+            targets.push_back(graph.AddOperation(OperationType::Blur, static_cast<float>(3 + 2 * i), source));
+        }
+        BenchGraph(settings, "fanout" + ToString(fanOut), graph, targets, size);
+    }
+
+    // Deep DAG: levels of nodes, each reading a node of the previous level, so
+    // branches split and share prefixes at every depth
+    {
+        GraphBuilder graph;
+        std::vector<int> level = {graph.AddSource(image)};
+        int index = 0;
+        for (int d = 0; d < depth; d++) {
+            std::vector<int> next;
+            for (int j = 0; j < width; j++) {
+                int input = level[(j * 3 + d) % level.size()];
+                next.push_back(AddMixedOperation(graph, index++, input));
+            }
+            level = next;
+        }
+        BenchGraph(settings, "dag" + ToString(depth) + "x" + ToString(width), graph, level, size);
+    }
+}
+
+// --- Sequences ---
+
+// Streams numbered frames through a mix of spatial and point operations into
+// numbered output frames, stage by stage against every stage on its own thread.
+// Decoding, the steps and encoding take comparable time, so pipelining should
+// approach the slowest stage's ms/frame rather than the sum.
+static void BenchSequence(const BenchSettings& settings) {
+    int frameCount = settings.quick ? 16 : 64;
+    cv::Size size = settings.quick ? cv::Size(640, 360) : cv::Size(1280, 720);
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "bench_sequence";
+    std::error_code ec;
+    std::filesystem::create_directories(dir / "out", ec);
+    for (int i = 0; i < frameCount; i++) {
+        cv::Mat frame(size, CV_8UC3);
+        cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+        char name[32];
+        snprintf(name, sizeof(name), "in_%04d.bmp", i);
+        if (!cv::imwrite((dir / name).string(), frame)) {
+            std::cerr << "Error: Cannot write " << (dir / name) << std::endl;
+            return;
+        }
+    }
+
+    GraphBuilder graph;
+    Node source;
+    source.id = static_cast<int>(graph.nodes.size());
+    source.type = OperationType::SequenceSource;
+    source.name = "Sequence Source";
+    source.outputSlotId = graph.nextSlot++;
+    source.imagePath = (dir / "in_*.bmp").string();
+    graph.nodes.Insert(source);
+    int last = graph.AddOperation(OperationType::Blur, 5.0f, source.id);
+    last = graph.AddOperation(OperationType::Brightness, 10.0f, last);
+    last = graph.AddOperation(OperationType::Blur, 3.0f, last);
+    last = graph.AddOperation(OperationType::Noise, 0.05f, last);
+    last = graph.AddOperation(OperationType::Blur, 5.0f, last);
+    Node sink;
+    sink.id = static_cast<int>(graph.nodes.size());
+    sink.type = OperationType::SequenceSink;
+    sink.name = "Sequence Output";
+    sink.inputSlotId = graph.nextSlot++;
+    sink.imagePath = (dir / "out" / "%04d.bmp").string();
+    graph.links.push_back({static_cast<int>(graph.links.size()), graph.nodes.FindById(last)->outputSlotId, sink.inputSlotId});
+    graph.nodes.Insert(sink);
+
+    double pixels = static_cast<double>(size.area()) * frameCount;
+    std::string shape = ToString(size.width) + "x" + ToString(size.height);
+    for (bool pipelined : {false, true}) {
+        std::string mode = pipelined ? "pipelined" : "serial";
+        SequenceOptions options;
+        options.pipelined = pipelined;
+        SequenceStats stats;
+        Measure(settings, "sequence/" + mode + "/" + shape, "sequence",
+                {{"frames", ToString(frameCount)}, {"size", shape}, {"mode", mode}}, pixels, [&]() {
+                    QuietStdout quiet;
+                    stats = SequenceStats();
+                    RunSequencePipeline({sink.id}, graph.nodes, graph.links, options, stats);
+                });
+        if (stats.frames > 0) std::cerr << FormatSequenceStats(stats) << std::endl;
+    }
+    std::filesystem::remove_all(dir, ec);
+}
+
+// --- Output ---
+
+static std::string JsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') escaped += '\\';
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+static void WriteJson(std::ostream& out, const BenchSettings& settings) {
+    std::time_t now = std::time(nullptr);
+    char timestamp[32];
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    out << "{\n  \"meta\": {\"timestamp\": " << JsonString(timestamp)
+        << ", \"opencv\": " << JsonString(CV_VERSION)
+        << ", \"pool_threads\": " << ThreadPool::shared().size()
+        << ", \"simd\": " << JsonString(SimdLevelName(DetectedSimdLevel()))
+        << ", \"fft_crossover_area\": " << ConvolutionFFTCrossoverArea()
+        << ", \"quick\": " << (settings.quick ? "true" : "false") << "},\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult& r = results[i];
+        out << "    {\"name\": " << JsonString(r.name) << ", \"group\": " << JsonString(r.group) << ", \"params\": {";
+        for (size_t p = 0; p < r.params.size(); p++) {
+            out << (p ? ", " : "") << JsonString(r.params[p].first) << ": " << JsonString(r.params[p].second);
+        }
+        out << "}, \"iterations\": " << r.iterations << ", \"min_ms\": " << r.minMs << ", \"median_ms\": " << r.medianMs
+            << ", \"mean_ms\": " << r.meanMs << ", \"mpix_per_s\": " << r.megapixelsPerSecond << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    BenchSettings settings;
+    std::string outPath;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            settings.quick = true;
+            settings.minSeconds = 0.1;
+            settings.minIterations = 3;
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            settings.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--quick] [--filter <substring>] [--out <file>]" << std::endl;
+            return 1;
+        }
+    }
+
+    CheckFastBlurAccuracy(settings);
+    BenchKernels(settings);
+    BenchConvolution(settings);
+    BenchDecode(settings);
+    BenchGraphs(settings);
+    BenchSequence(settings);
+
+    if (outPath.empty()) {
+        WriteJson(std::cout, settings);
+    } else {
+        std::ofstream out(outPath);
+        if (!out) {
+            std::cerr << "Error: Cannot write " << outPath << std::endl;
+            return 1;
+        }
+        WriteJson(out, settings);
+        std::cerr << "Wrote " << results.size() << " results to " << outPath << std::endl;
+    }
+    if (failedChecks > 0) {
+        std::cerr << failedChecks << " correctness check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "AsyncEvaluator.h"
+#include "ThreadPool.h"
+#include <iostream>
+
+AsyncEvaluator::~AsyncEvaluator() {
+    Shutdown();
+}
+
+void AsyncEvaluator::Start(const std::vector<int>& displayIds, const std::vector<int>& targetIds,
+                           const NodeStore& nodes, const std::vector<Link>& links, const EvalOptions& options) {
+    auto job = std::make_shared<Job>();
+    job->nodes = nodes;
+    job->links = links;
+    job->displayIds = displayIds;
+    job->targetIds = targetIds;
+    job->options = options;
+    job->options.progress = &job->progress;
+    job->options.profile = job->profile.get();
+    for (const Node& node : job->nodes) {
+        bool source = node.type == OperationType::LoadImage || node.type == OperationType::SequenceSource;
+        if (!source) continue;
+        const NodeImages& images = job->nodes.Images(node);
+        if (!images.loadedCvImage.has_value() || !images.reducedCvImage.has_value()) {
+            job->undecodedSources.push_back({node.id, !images.loadedCvImage.has_value(), !images.reducedCvImage.has_value()});
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (int displayId : displayIds) {
+            DisplaySlot& slot = slots[displayId];
+            // Restarting supersedes whatever was running or waiting for this display;
+            // a run shared with other displays keeps going for them
+            Assign(slot, job);
+            slot.resultReady = false;
+            slot.result.release();
+        }
+        runningJobs++;
+    }
+
+    ThreadPool::shared().submit([this, job]() {
+        std::vector<cv::Mat> outputs;
+        bool ok = ProcessGraphTargets(job->targetIds, cache, job->nodes, job->links, outputs, job->options);
+        Finish(job, ok, outputs);
+    });
+}
+
+void AsyncEvaluator::Assign(DisplaySlot& slot, const std::shared_ptr<Job>& job) {
+    if (slot.job == job) return;
+    if (slot.job && --slot.job->waitingDisplays == 0) slot.job->progress.cancelled = true;
+    slot.job = job;
+    if (job) job->waitingDisplays++;
+}
+
+void AsyncEvaluator::Finish(const std::shared_ptr<Job>& job, bool ok, const std::vector<cv::Mat>& outputs) {
+    std::map<int, NodeProfile> profiles = job->profile->NodeProfiles();
+    std::lock_guard<std::mutex> lock(mutex);
+    // The snapshot dies with the job, hand decodes it made over to the live graph
+    for (const Job::MissingDecodes& missing : job->undecodedSources) {
+        if (job->progress.cancelled) break; // The graph may have been replaced meanwhile
+        const Node* node = job->nodes.FindById(missing.nodeId);
+        const NodeImages& images = job->nodes.Images(*node);
+        DecodedSource decoded;
+        decoded.version = node->version;
+        decoded.sourceSize = images.sourceSize;
+        if (missing.full && images.loadedCvImage.has_value()) decoded.full = images.loadedCvImage.value();
+        if (missing.reduced && images.reducedCvImage.has_value()) decoded.reduced = images.reducedCvImage.value();
+        if (decoded.full.empty() && decoded.reduced.empty()) continue;
+        decodedSources[missing.nodeId] = decoded;
+        readyNodes.insert(missing.nodeId);
+    }
+    if (!job->progress.cancelled) {
+        for (const auto& entry : profiles) freshProfiles[entry.first] = entry.second;
+        lastProfile = job->profile;
+    }
+    for (size_t i = 0; i < job->displayIds.size(); i++) {
+        DisplaySlot& slot = slots[job->displayIds[i]];
+        if (slot.job != job) continue; // A newer run took over this display, or it was cancelled
+
+        slot.job.reset();
+        slot.resultReady = true;
+        slot.result = ok ? outputs[i] : cv::Mat();
+        readyNodes.insert(job->displayIds[i]);
+    }
+    runningJobs--;
+    jobsDone.notify_all();
+}
+
+void AsyncEvaluator::Cancel(int displayId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto slot = slots.find(displayId);
+    if (slot != slots.end()) Assign(slot->second, nullptr);
+    decodedSources.erase(displayId);
+}
+
+bool AsyncEvaluator::TakeResult(int displayId, cv::Mat& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto slot = slots.find(displayId);
+    if (slot == slots.end() || !slot->second.resultReady) return false;
+
+    result = slot->second.result;
+    slot->second.result.release();
+    slot->second.resultReady = false;
+    return true;
+}
+
+bool AsyncEvaluator::IsBusy(int displayId, float& progress) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto slot = slots.find(displayId);
+    if (slot == slots.end() || !slot->second.job) return false;
+
+    progress = slot->second.job->progress.Fraction();
+    return true;
+}
+
+bool AsyncEvaluator::TakeDecodedSource(int nodeId, DecodedSource& decoded) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = decodedSources.find(nodeId);
+    if (found == decodedSources.end()) return false;
+    decoded = std::move(found->second);
+    decodedSources.erase(found);
+    return true;
+}
+
+void AsyncEvaluator::TakeReadyNodes(std::vector<int>& nodeIds) {
+    std::lock_guard<std::mutex> lock(mutex);
+    nodeIds.insert(nodeIds.end(), readyNodes.begin(), readyNodes.end());
+    readyNodes.clear();
+}
+
+void AsyncEvaluator::TakeNodeProfiles(std::map<int, NodeProfile>& profiles) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : freshProfiles) profiles[entry.first] = entry.second;
+    freshProfiles.clear();
+}
+
+bool AsyncEvaluator::WriteLastTrace(const std::string& path) {
+    std::shared_ptr<EvalProfile> profile;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        profile = lastProfile;
+    }
+    if (!profile) {
+        std::cerr << "Error: No finished evaluation to export yet" << std::endl;
+        return false;
+    }
+    return profile->WriteChromeTrace(path);
+}
+
+void AsyncEvaluator::CancelAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& entry : slots) {
+        if (entry.second.job) entry.second.job->progress.cancelled = true;
+    }
+    slots.clear();
+    decodedSources.clear();
+    readyNodes.clear();
+}
+
+void AsyncEvaluator::Shutdown() {
+    CancelAll();
+    std::unique_lock<std::mutex> lock(mutex);
+    jobsDone.wait(lock, [this]() { return runningJobs == 0; });
+}
@@ -0,0 +1,108 @@
+#ifndef ASYNC_EVALUATOR_H
+#define ASYNC_EVALUATOR_H
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "utils.h"
+
+// Runs graph evaluations on the shared thread pool so the UI thread never
+// blocks. Results are double-buffered: a finished image waits in a pending
+// slot until the render thread takes it (and uploads the texture), while the
+// image currently shown stays untouched in the display node.
+class AsyncEvaluator {
+public:
+    explicit AsyncEvaluator(EvalCache& cache) : cache(cache) {}
+    ~AsyncEvaluator();
+
+    // Starts evaluating targetIds[i] for display node displayIds[i] on a
+    // snapshot of the graph. A run still in flight for those displays no
+    // longer delivers to them; it is cancelled once no display waits on it.
+    void Start(const std::vector<int>& displayIds, const std::vector<int>& targetIds,
+               const NodeStore& nodes, const std::vector<Link>& links, const EvalOptions& options);
+
+    // Detaches a display node from its run, cancelling the run if no other
+    // display waits on it. Also drops decodes left for a deleted source.
+    void Cancel(int displayId);
+
+    // Hands over a finished result once; an empty image means the run failed
+    bool TakeResult(int displayId, cv::Mat& result);
+
+    // True while a run for the display is in flight, progress receives 0..1
+    bool IsBusy(int displayId, float& progress);
+
+    // Cancels every run and drops pending results, e.g. when the graph is replaced
+    void CancelAll();
+
+    // Cancels every run and waits for them to wind down
+    void Shutdown();
+
+    // Decodes of a source that a run had to make itself, taken once: a full
+    // decode for Full Res, Save Image or tiled runs in preview mode, or either
+    // kind after the memory budget evicted the node's own. Empty Mats for what
+    // the run did not decode. version is the node's version in the run's
+    // snapshot; the caller drops the images if the live node moved on to
+    // another file meanwhile.
+    struct DecodedSource {
+        int version = 0;
+        cv::Mat full;
+        cv::Mat reduced;
+        cv::Size sourceSize;
+    };
+    bool TakeDecodedSource(int nodeId, DecodedSource& decoded);
+
+    // Moves the ids of display nodes with a result and of sources with
+    // decodes to hand over, both since the last call, into nodeIds
+    void TakeReadyNodes(std::vector<int>& nodeIds);
+
+    // Merges the node timings of runs finished since the last call into profiles
+    void TakeNodeProfiles(std::map<int, NodeProfile>& profiles);
+
+    // Writes the timeline of the most recently finished run as a Chrome trace
+    bool WriteLastTrace(const std::string& path);
+
+private:
+    struct Job {
+        NodeStore nodes;  // Snapshot, the UI may edit the live graph meanwhile
+        std::vector<Link> links;
+        std::vector<int> displayIds;
+        std::vector<int> targetIds;
+        EvalOptions options;
+        EvalProgress progress;
+        int waitingDisplays = 0; // Slots still pointing at this job, guarded by mutex
+        struct MissingDecodes {
+            int nodeId;
+            bool full;    // No loadedCvImage in the snapshot when the run started
+            bool reduced; // No reducedCvImage either
+        };
+        std::vector<MissingDecodes> undecodedSources;
+        std::shared_ptr<EvalProfile> profile = std::make_shared<EvalProfile>();
+    };
+
+    struct DisplaySlot {
+        std::shared_ptr<Job> job;  // Latest run, null once it finished
+        bool resultReady = false;
+        cv::Mat result;            // Back buffer, swapped out by TakeResult
+    };
+
+    // Points slot at job (or nothing), cancelling the previous job once no display waits on it
+    void Assign(DisplaySlot& slot, const std::shared_ptr<Job>& job);
+    void Finish(const std::shared_ptr<Job>& job, bool ok, const std::vector<cv::Mat>& outputs);
+
+    EvalCache& cache;
+    std::mutex mutex;
+    std::condition_variable jobsDone;
+    std::map<int, DisplaySlot> slots; // Keyed by display node id
+    int runningJobs = 0;
+    std::map<int, DecodedSource> decodedSources; // Keyed by node id
+    std::set<int> readyNodes;                    // Not yet reported by TakeReadyNodes
+    std::map<int, NodeProfile> freshProfiles;   // Keyed by node id
+    std::shared_ptr<EvalProfile> lastProfile;
+};
+
+#endif // ASYNC_EVALUATOR_H
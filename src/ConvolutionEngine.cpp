@@ -0,0 +1,280 @@
+#include "ConvolutionEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <tuple>
+
+const char* ConvolutionMethodName(ConvolutionMethod method) {
+    switch (method) {
+        case ConvolutionMethod::Separable: return "separable";
+        case ConvolutionMethod::Direct: return "direct";
+        case ConvolutionMethod::FFT: return "fft";
+    }
+    return "unknown";
+}
+
+// --- Parsing ---
+
+bool ParseConvolutionKernel(const std::string& text, cv::Mat& kernel, std::string& error) {
+    std::vector<std::vector<float>> rows;
+    std::stringstream rowStream(text);
+    std::string rowText;
+    while (std::getline(rowStream, rowText, ';')) {
+        std::replace(rowText.begin(), rowText.end(), ',', ' ');
+        std::istringstream values(rowText);
+        std::vector<float> row;
+        std::string token;
+        while (values >> token) {
+            try {
+                size_t used = 0;
+                row.push_back(std::stof(token, &used));
+                if (used != token.size()) throw std::invalid_argument(token);
+            } catch (const std::exception&) {
+                error = "Invalid number '" + token + "'";
+                return false;
+            }
+        }
+        if (!row.empty()) rows.push_back(row);
+    }
+
+    if (rows.empty()) {
+        error = "Kernel is empty";
+        return false;
+    }
+    for (const auto& row : rows) {
+        if (row.size() != rows[0].size()) {
+            error = "Kernel rows have different lengths";
+            return false;
+        }
+    }
+
+    kernel.create(static_cast<int>(rows.size()), static_cast<int>(rows[0].size()), CV_32F);
+    for (int y = 0; y < kernel.rows; y++) {
+        std::copy(rows[y].begin(), rows[y].end(), kernel.ptr<float>(y));
+    }
+    return true;
+}
+
+// --- Kernel analysis ---
+
+static uint64_t KernelHash(const cv::Mat& kernel) {
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t v) {
+        for (int i = 0; i < 8; i++) {
+            hash ^= (v >> (i * 8)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(static_cast<uint64_t>(kernel.rows));
+    mix(static_cast<uint64_t>(kernel.cols));
+    for (int y = 0; y < kernel.rows; y++) {
+        for (int x = 0; x < kernel.cols; x++) {
+            uint32_t bits;
+            float value = kernel.at<float>(y, x);
+            memcpy(&bits, &value, sizeof(bits));
+            mix(bits);
+        }
+    }
+    return hash;
+}
+
+// What the engine learned about a kernel, cached by kernel hash
+struct KernelAnalysis {
+    bool separable = false;
+    cv::Mat rowKernel;    // 1 x cols, horizontal factor
+    cv::Mat columnKernel; // rows x 1, vertical factor
+};
+
+static std::mutex analysisMutex;
+static std::map<uint64_t, KernelAnalysis> analysisCache;
+static const size_t maxAnalysisEntries = 64;
+
+// A kernel is separable when its second singular value is negligible; the
+// factors are then the first singular vectors, each carrying sqrt(s0)
+static KernelAnalysis AnalyseKernel(const cv::Mat& kernel) {
+    uint64_t hash = KernelHash(kernel);
+    {
+        std::lock_guard<std::mutex> lock(analysisMutex);
+        auto cached = analysisCache.find(hash);
+        if (cached != analysisCache.end()) return cached->second;
+    }
+
+    KernelAnalysis analysis;
+    cv::Mat kernel64;
+    kernel.convertTo(kernel64, CV_64F);
+    cv::SVD svd(kernel64, cv::SVD::FULL_UV);
+    double first = svd.w.at<double>(0);
+    double second = svd.w.rows > 1 ? svd.w.at<double>(1) : 0.0;
+    if (first > 0.0 && second <= first * 1e-5 && kernel.rows * kernel.cols > 1) {
+        double weight = std::sqrt(first);
+        cv::Mat column = svd.u.col(0) * weight;
+        cv::Mat row = svd.vt.row(0) * weight;
+        column.convertTo(analysis.columnKernel, CV_32F);
+        row.convertTo(analysis.rowKernel, CV_32F);
+        analysis.separable = true;
+    }
+
+    std::lock_guard<std::mutex> lock(analysisMutex);
+    if (analysisCache.size() >= maxAnalysisEntries) analysisCache.clear();
+    analysisCache[hash] = analysis;
+    return analysis;
+}
+
+// --- FFT path ---
+
+// Forward spectra of zero-padded kernels, keyed by kernel hash and transform
+// size. Kept in least recently used order, front is the oldest.
+struct SpectrumEntry {
+    std::tuple<uint64_t, int, int> key;
+    cv::Mat spectrum;
+};
+
+static std::mutex spectrumMutex;
+static std::list<SpectrumEntry> spectrumCache;
+static const size_t maxSpectrumEntries = 16;
+
+static cv::Mat ComputeKernelSpectrum(const cv::Mat& kernel, cv::Size dftSize) {
+    cv::Mat padded = cv::Mat::zeros(dftSize, CV_32F);
+    kernel.copyTo(padded(cv::Rect(0, 0, kernel.cols, kernel.rows)));
+    cv::Mat spectrum;
+    cv::dft(padded, spectrum, 0, kernel.rows);
+    return spectrum;
+}
+
+static cv::Mat KernelSpectrum(const cv::Mat& kernel, cv::Size dftSize) {
+    auto key = std::make_tuple(KernelHash(kernel), dftSize.height, dftSize.width);
+    {
+        std::lock_guard<std::mutex> lock(spectrumMutex);
+        for (auto it = spectrumCache.begin(); it != spectrumCache.end(); ++it) {
+            if (it->key != key) continue;
+            spectrumCache.splice(spectrumCache.end(), spectrumCache, it);
+            return it->spectrum;
+        }
+    }
+
+    // Computed outside the lock; two threads racing on the same kernel both
+    // produce the same spectrum and the second insert is harmless
+    cv::Mat spectrum = ComputeKernelSpectrum(kernel, dftSize);
+    std::lock_guard<std::mutex> lock(spectrumMutex);
+    spectrumCache.push_back({key, spectrum});
+    if (spectrumCache.size() > maxSpectrumEntries) spectrumCache.pop_front();
+    return spectrum;
+}
+
+// Correlation through the frequency domain. src is reflected by the kernel's
+// anchor offsets (as filter2D would) and zero-padded to a fast transform size;
+// the first rows x cols samples of the circular correlation are then exactly
+// the linear result, since no output sample reads past the padded image.
+static void ConvolveFFTWithSpectrum(const cv::Mat& src, cv::Mat& dst, cv::Size kernelSize, const cv::Mat& spectrum, cv::Size dftSize) {
+    int top = kernelSize.height / 2, left = kernelSize.width / 2;
+    int bottom = kernelSize.height - 1 - top, right = kernelSize.width - 1 - left;
+    int paddedRows = src.rows + kernelSize.height - 1;
+
+    std::vector<cv::Mat> channels;
+    cv::split(src, channels);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(channels.size())), [&](const cv::Range& range) {
+        for (int c = range.start; c < range.end; c++) {
+            cv::Mat plane = cv::Mat::zeros(dftSize, CV_32F);
+            cv::Mat reflected;
+            cv::copyMakeBorder(channels[c], reflected, top, bottom, left, right, cv::BORDER_REFLECT_101);
+            reflected.convertTo(plane(cv::Rect(0, 0, reflected.cols, reflected.rows)), CV_32F);
+
+            cv::Mat planeSpectrum, product, result;
+            cv::dft(plane, planeSpectrum, 0, paddedRows);
+            cv::mulSpectrums(planeSpectrum, spectrum, product, 0, true); // Conjugate kernel: correlation
+            cv::dft(product, result, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT, src.rows);
+            channels[c] = result(cv::Rect(0, 0, src.cols, src.rows));
+        }
+    });
+
+    cv::Mat merged;
+    cv::merge(channels, merged);
+    merged.convertTo(dst, src.depth()); // Rounds and saturates back to the input's depth
+}
+
+static cv::Size DftSizeFor(cv::Size imageSize, cv::Size kernelSize) {
+    return cv::Size(cv::getOptimalDFTSize(imageSize.width + kernelSize.width - 1),
+                    cv::getOptimalDFTSize(imageSize.height + kernelSize.height - 1));
+}
+
+static void ConvolveFFT(const cv::Mat& src, cv::Mat& dst, const cv::Mat& kernel) {
+    cv::Size dftSize = DftSizeFor(src.size(), kernel.size());
+    ConvolveFFTWithSpectrum(src, dst, kernel.size(), KernelSpectrum(kernel, dftSize), dftSize);
+}
+
+// --- Crossover calibration ---
+
+static int fftCrossoverArea = INT_MAX;
+static std::once_flag calibrationOnce;
+
+template <typename Function>
+static double BestMilliseconds(Function function) {
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+// Times direct filtering against the FFT path (spectrum already cached, as it
+// is in steady state) on a 3-channel 8-bit image for growing non-separable
+// kernels, and takes the first size where FFT wins. Runs once, ~100ms.
+static void CalibrateCrossover() {
+    cv::Mat image(384, 384, CV_8UC3);
+    cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+    cv::Mat output;
+
+    for (int size : {5, 7, 9, 11, 15, 21, 31, 45}) {
+        cv::Mat kernel(size, size, CV_32F);
+        cv::randu(kernel, cv::Scalar(-1.0), cv::Scalar(1.0));
+        cv::Size dftSize = DftSizeFor(image.size(), kernel.size());
+        cv::Mat spectrum = ComputeKernelSpectrum(kernel, dftSize);
+
+        double direct = BestMilliseconds([&] { cv::filter2D(image, output, -1, kernel, cv::Point(-1, -1), 0, cv::BORDER_REFLECT_101); });
+        double fft = BestMilliseconds([&] { ConvolveFFTWithSpectrum(image, output, kernel.size(), spectrum, dftSize); });
+        if (fft < direct) {
+            fftCrossoverArea = size * size;
+            break;
+        }
+    }
+}
+
+int ConvolutionFFTCrossoverArea() {
+    std::call_once(calibrationOnce, CalibrateCrossover);
+    return fftCrossoverArea;
+}
+
+// --- Dispatch ---
+
+ConvolutionMethod ChooseConvolutionMethod(const cv::Mat& kernel) {
+    if (AnalyseKernel(kernel).separable) return ConvolutionMethod::Separable;
+    return kernel.rows * kernel.cols >= ConvolutionFFTCrossoverArea() ? ConvolutionMethod::FFT : ConvolutionMethod::Direct;
+}
+
+void Convolve(const cv::Mat& src, cv::Mat& dst, const cv::Mat& kernel, ConvolutionMethod method) {
+    switch (method) {
+        case ConvolutionMethod::Separable: {
+            KernelAnalysis analysis = AnalyseKernel(kernel);
+            if (analysis.separable) {
+                cv::sepFilter2D(src, dst, -1, analysis.rowKernel, analysis.columnKernel, cv::Point(-1, -1), 0, cv::BORDER_REFLECT_101);
+                return;
+            }
+            break; // Not rank 1, fall back to direct filtering
+        }
+        case ConvolutionMethod::FFT:
+            ConvolveFFT(src, dst, kernel);
+            return;
+        case ConvolutionMethod::Direct:
+            break;
+    }
+    cv::filter2D(src, dst, -1, kernel, cv::Point(-1, -1), 0, cv::BORDER_REFLECT_101);
+}
@@ -0,0 +1,34 @@
+#ifndef CONVOLUTION_ENGINE_H
+#define CONVOLUTION_ENGINE_H
+
+#include <string>
+#include <opencv2/opencv.hpp>
+
+// Strategy for applying a user kernel, picked per kernel by ChooseConvolutionMethod
+enum class ConvolutionMethod {
+    Separable, // Rank-1 kernel, one row pass and one column pass (sepFilter2D)
+    Direct,    // Small kernel, vectorised sliding window (filter2D)
+    FFT        // Large kernel, pointwise product of spectra
+};
+
+const char* ConvolutionMethodName(ConvolutionMethod method);
+
+// Parses "a b c; d e f; g h i" (values separated by spaces or commas, rows by
+// ';') into a CV_32F kernel. Rows must have equal length. On failure error
+// receives a short description.
+bool ParseConvolutionKernel(const std::string& text, cv::Mat& kernel, std::string& error);
+
+// Rank-1 kernels go separable. Otherwise direct filtering is used up to the
+// kernel area where FFT becomes faster on this machine, measured once on first use.
+ConvolutionMethod ChooseConvolutionMethod(const cv::Mat& kernel);
+
+// Correlates src with kernel like filter2D (anchor at the centre,
+// BORDER_REFLECT_101), dst gets src's size and type. Kernel spectra for the
+// FFT method are cached per kernel and transform size.
+void Convolve(const cv::Mat& src, cv::Mat& dst, const cv::Mat& kernel, ConvolutionMethod method);
+
+// Smallest kernel area (rows * cols) for which the FFT path beat direct
+// filtering during calibration
+int ConvolutionFFTCrossoverArea();
+
+#endif // CONVOLUTION_ENGINE_H
@@ -0,0 +1,268 @@
+#include "DiskCache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <tuple>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// --- File format ---
+
+static const char fileMagic[8] = {'N', 'G', 'C', 'A', 'C', 'H', 'E', '1'};
+static const char* fileExtension = ".ngc";
+// Store writes to <entry>.tmp<pid>_<tid> first; one this old was left by a
+// process that died mid-write, a live writer finishes within seconds
+static const auto staleTemporaryAge = std::chrono::minutes(10);
+
+// Rows follow the header back to back, rowBytes apart. The header size keeps
+// the pixels 64-byte aligned in the (page-aligned) mapping.
+struct FileHeader {
+    char magic[8];
+    uint64_t key;
+    int32_t rows;
+    int32_t cols;
+    int32_t type;
+    int32_t reserved;
+    uint64_t rowBytes;
+    uint8_t padding[24];
+};
+static_assert(sizeof(FileHeader) == 64, "cache file header must stay 64 bytes");
+
+// --- Mapped Mats ---
+
+// Owns the mapping behind Mats returned by Lookup: OpenCV calls deallocate
+// once the last Mat sharing the pixels is released. Buffers allocated for
+// Mats that later call create() come from the default allocator as usual.
+class MappedFileAllocator : public cv::MatAllocator {
+public:
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data, size_t* step,
+                           cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        return cv::Mat::getDefaultAllocator()->allocate(dims, sizes, type, data, step, flags, usageFlags);
+    }
+
+    bool allocate(cv::UMatData* data, cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override {
+        return cv::Mat::getDefaultAllocator()->allocate(data, flags, usageFlags);
+    }
+
+    void deallocate(cv::UMatData* data) const override {
+        if (!data) return;
+        munmap(data->origdata, data->size);
+        delete data;
+    }
+
+    static const MappedFileAllocator& instance() {
+        static MappedFileAllocator allocator;
+        return allocator;
+    }
+};
+
+// Wraps the pixels of a mapped cache file, the Mat takes over the mapping
+static cv::Mat WrapMapping(void* base, size_t length, const FileHeader& header) {
+    uchar* pixels = static_cast<uchar*>(base) + sizeof(FileHeader);
+    cv::Mat image(header.rows, header.cols, header.type, pixels, static_cast<size_t>(header.rowBytes));
+    cv::UMatData* owner = new cv::UMatData(&MappedFileAllocator::instance());
+    owner->data = owner->origdata = static_cast<uchar*>(base);
+    owner->size = length;
+    owner->refcount = 1; // Held by image
+    image.u = owner;
+    return image;
+}
+
+// --- DiskCache ---
+
+DiskCache::DiskCache(const std::string& directory, uint64_t maxBytes) : root(directory), maxBytes(maxBytes) {
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot create cache directory " << root << ": " << ec.message() << std::endl;
+        return;
+    }
+
+    // Oldest first, so the LRU order picks up where the last session left it
+    std::vector<std::tuple<fs::file_time_type, uint64_t, uint64_t>> found;
+    int staleTemporaries = 0;
+    for (const auto& entry : fs::directory_iterator(root, ec)) {
+        const fs::path& path = entry.path();
+        if (path.filename().string().find(std::string(fileExtension) + ".tmp") != std::string::npos) {
+            std::error_code removeError;
+            fs::file_time_type written = entry.last_write_time(removeError);
+            if (!removeError && fs::file_time_type::clock::now() - written > staleTemporaryAge && fs::remove(path, removeError)) {
+                staleTemporaries++;
+            }
+            continue;
+        }
+        std::string stem = path.stem().string();
+        if (path.extension() != fileExtension || stem.size() != 16 || !entry.is_regular_file()) continue;
+        if (stem.find_first_not_of("0123456789abcdef") != std::string::npos) continue;
+        found.emplace_back(entry.last_write_time(ec), std::stoull(stem, nullptr, 16), entry.file_size(ec));
+    }
+    std::sort(found.begin(), found.end());
+    if (staleTemporaries > 0) {
+        std::cout << "Disk cache: removed " << staleTemporaries << " unfinished writes left in " << root << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : found) Track(std::get<1>(entry), std::get<2>(entry));
+    EvictToCap();
+}
+
+std::string DiskCache::PathFor(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return (fs::path(root) / (std::string(name) + fileExtension)).string();
+}
+
+void DiskCache::Track(uint64_t key, uint64_t bytes) {
+    auto found = entries.find(key);
+    if (found != entries.end()) {
+        lruOrder.splice(lruOrder.end(), lruOrder, found->second.position);
+        return;
+    }
+    lruOrder.push_back(key);
+    entries[key] = {bytes, std::prev(lruOrder.end())};
+    counters.totalBytes += bytes;
+}
+
+void DiskCache::Forget(uint64_t key) {
+    auto found = entries.find(key);
+    if (found == entries.end()) return;
+    counters.totalBytes -= found->second.bytes;
+    lruOrder.erase(found->second.position);
+    entries.erase(found);
+}
+
+void DiskCache::EvictToCap() {
+    while (counters.totalBytes > maxBytes && !lruOrder.empty()) {
+        uint64_t key = lruOrder.front();
+        std::error_code ec;
+        fs::remove(PathFor(key), ec); // Mappings of it stay valid until released
+        Forget(key);
+        counters.evictions++;
+    }
+}
+
+bool DiskCache::Lookup(uint64_t key, cv::Mat& image) {
+    std::string path = PathFor(key);
+    auto miss = [&]() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Forget(key); // Evicted or replaced by another process, if it was known
+        counters.misses++;
+        return false;
+    };
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return miss();
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        return miss();
+    }
+    size_t length = static_cast<size_t>(info.st_size);
+    // Private and writable: consumers may overwrite the pixels in place, which
+    // copies the touched pages instead of changing the file
+    void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping keeps the file alive
+    if (base == MAP_FAILED) return miss();
+
+    const FileHeader& header = *static_cast<const FileHeader*>(base);
+    bool valid = memcmp(header.magic, fileMagic, sizeof(fileMagic)) == 0 && header.key == key && header.rows > 0 &&
+                 header.cols > 0 && header.rowBytes >= static_cast<uint64_t>(header.cols) * CV_ELEM_SIZE(header.type) &&
+                 length == sizeof(FileHeader) + header.rowBytes * static_cast<uint64_t>(header.rows);
+    if (!valid) {
+        munmap(base, length);
+        std::cerr << "Warning: Dropping corrupt cache file " << path << std::endl;
+        std::error_code ec;
+        fs::remove(path, ec);
+        return miss();
+    }
+    image = WrapMapping(base, length, header);
+
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec); // Recently used, for later sessions too
+    std::lock_guard<std::mutex> lock(mutex);
+    Track(key, length);
+    counters.hits++;
+    counters.bytesRead += length;
+    return true;
+}
+
+void DiskCache::Store(uint64_t key, const cv::Mat& image) {
+    if (image.empty() || image.dims != 2 || image.channels() > 4) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (entries.count(key)) return;
+    }
+
+    FileHeader header = {};
+    memcpy(header.magic, fileMagic, sizeof(fileMagic));
+    header.key = key;
+    header.rows = image.rows;
+    header.cols = image.cols;
+    header.type = image.type();
+    header.rowBytes = static_cast<uint64_t>(image.cols) * image.elemSize();
+    uint64_t length = sizeof(FileHeader) + header.rowBytes * image.rows;
+
+    // Written under a name unique to this process and thread, then renamed into place
+    std::string path = PathFor(key);
+    std::string temporary = path + ".tmp" + std::to_string(getpid()) + "_" +
+                            std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream out(temporary, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (int y = 0; y < image.rows && out; y++) {
+            out.write(reinterpret_cast<const char*>(image.ptr(y)), static_cast<std::streamsize>(header.rowBytes));
+        }
+        if (!out) {
+            std::cerr << "Error: Cannot write cache file " << temporary << std::endl;
+            out.close();
+            std::error_code ec;
+            fs::remove(temporary, ec);
+            return;
+        }
+    }
+    std::error_code ec;
+    fs::rename(temporary, path, ec);
+    if (ec) {
+        fs::remove(temporary, ec);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    Track(key, length);
+    counters.stores++;
+    counters.bytesWritten += length;
+    EvictToCap();
+}
+
+void DiskCache::SetMaxBytes(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    maxBytes = bytes;
+    EvictToCap();
+}
+
+void DiskCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint64_t key : lruOrder) {
+        std::error_code ec;
+        fs::remove(PathFor(key), ec);
+    }
+    lruOrder.clear();
+    entries.clear();
+    counters.totalBytes = 0;
+}
+
+DiskCache::Stats DiskCache::stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats snapshot = counters;
+    snapshot.entries = entries.size();
+    return snapshot;
+}
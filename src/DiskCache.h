@@ -0,0 +1,76 @@
+#ifndef DISK_CACHE_H
+#define DISK_CACHE_H
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+// Node results kept on disk across sessions and batch runs, addressed by
+// content key: a hash of the source pixels, node types, parameters and the
+// upstream chain, never of node ids or edit counters. The editor and batch
+// can therefore share one directory, and an unchanged graph over unchanged
+// files finds every result it computed before.
+//
+// Each entry is one file, a 64-byte header followed by the raw rows. A hit
+// maps the file copy-on-write and wraps the mapping in a cv::Mat, so it costs
+// a page-table setup instead of a decode; pixels are paged in as they are read,
+// and writing to the Mat never touches the file. Entries are evicted least
+// recently used first once the directory exceeds its size cap. Lookups touch
+// the file's modification time, which carries the LRU order across sessions.
+// Safe to use from the evaluator's worker threads and from several processes.
+class DiskCache {
+public:
+    // Indexes the entries already in directory (created if missing) and
+    // deletes temporary files that crashed writers left behind
+    DiskCache(const std::string& directory, uint64_t maxBytes);
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
+
+    bool Lookup(uint64_t key, cv::Mat& image);
+
+    // Writes image under key unless an entry exists; 2-D images of any depth
+    // and up to 4 channels. The file appears atomically, readers never see it half-written.
+    void Store(uint64_t key, const cv::Mat& image);
+
+    // Evicts down to the new cap right away
+    void SetMaxBytes(uint64_t maxBytes);
+    void Clear();
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;
+        uint64_t bytesRead = 0;    // Mapped by hits
+        uint64_t bytesWritten = 0;
+        uint64_t totalBytes = 0;   // Currently on disk
+        size_t entries = 0;
+    };
+    Stats stats();
+
+    const std::string& directory() const { return root; }
+
+private:
+    struct Entry {
+        uint64_t bytes = 0;
+        std::list<uint64_t>::iterator position; // In lruOrder
+    };
+
+    std::string PathFor(uint64_t key) const;
+    void Track(uint64_t key, uint64_t bytes); // Caller holds mutex
+    void Forget(uint64_t key);                // Caller holds mutex
+    void EvictToCap();                        // Caller holds mutex
+
+    std::string root;
+    uint64_t maxBytes;
+    std::mutex mutex;
+    std::list<uint64_t> lruOrder; // Front is the least recently used
+    std::unordered_map<uint64_t, Entry> entries;
+    Stats counters;
+};
+
+#endif // DISK_CACHE_H
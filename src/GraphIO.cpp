@@ -0,0 +1,156 @@
+#include "GraphIO.h"
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+const char* OperationTypeToString(OperationType type) {
+    switch (type) {
+        case OperationType::Blur: return "Blur";
+        case OperationType::Brightness: return "Brightness";
+        case OperationType::Contrast: return "Contrast";
+        case OperationType::LoadImage: return "LoadImage";
+        case OperationType::ProcessDisplay: return "ProcessDisplay";
+        case OperationType::Convolution: return "Convolution";
+        case OperationType::Noise: return "Noise";
+        case OperationType::SequenceSource: return "SequenceSource";
+        case OperationType::SequenceSink: return "SequenceSink";
+    }
+    return "Unknown";
+}
+
+bool OperationTypeFromString(const std::string& name, OperationType& type) {
+    if (name == "Blur") type = OperationType::Blur;
+    else if (name == "Brightness") type = OperationType::Brightness;
+    else if (name == "Contrast") type = OperationType::Contrast;
+    else if (name == "LoadImage") type = OperationType::LoadImage;
+    else if (name == "ProcessDisplay") type = OperationType::ProcessDisplay;
+    else if (name == "Convolution") type = OperationType::Convolution;
+    else if (name == "Noise") type = OperationType::Noise;
+    else if (name == "SequenceSource") type = OperationType::SequenceSource;
+    else if (name == "SequenceSink") type = OperationType::SequenceSink;
+    else return false;
+    return true;
+}
+
+// Names match the ones used by the side panel buttons in the editor
+static const char* DefaultNodeName(OperationType type) {
+    switch (type) {
+        case OperationType::Blur: return "Blur Node";
+        case OperationType::Brightness: return "Brightness Node";
+        case OperationType::Contrast: return "Contrast Node";
+        case OperationType::LoadImage: return "Load Image";
+        case OperationType::ProcessDisplay: return "Process & Display";
+        case OperationType::Convolution: return "Convolution Node";
+        case OperationType::Noise: return "Noise Node";
+        case OperationType::SequenceSource: return "Sequence Source";
+        case OperationType::SequenceSink: return "Sequence Output";
+    }
+    return "Node";
+}
+
+bool SaveGraph(const std::string& path, const NodeStore& nodes, const std::vector<Link>& links) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Error: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    out << "# node <id> <type> <x> <y> <width> <inputSlot> <outputSlot> <value|-> [path|kernel|seed]\n";
+    out << "# link <id> <fromSlot> <toSlot>\n";
+    for (const Node& node : nodes) {
+        out << "node " << node.id << ' ' << OperationTypeToString(node.type) << ' '
+            << node.position.x << ' ' << node.position.y << ' ' << node.width << ' '
+            << node.inputSlotId << ' ' << node.outputSlotId << ' ';
+        if (node.value.has_value()) out << node.value.value();
+        else out << '-';
+        // Path or kernel goes last so it may contain spaces
+        if (node.imagePath.has_value() && !node.imagePath.value().empty()) out << ' ' << node.imagePath.value();
+        else if (node.kernelText.has_value() && !node.kernelText.value().empty()) out << ' ' << node.kernelText.value();
+        else if (node.seed.has_value()) out << ' ' << node.seed.value();
+        out << '\n';
+    }
+    for (const Link& link : links) {
+        out << "link " << link.id << ' ' << link.fromSlot << ' ' << link.toSlot << '\n';
+    }
+
+    return static_cast<bool>(out);
+}
+
+bool LoadGraph(const std::string& path, NodeStore& nodes, std::vector<Link>& links) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Error: Could not open graph file " << path << std::endl;
+        return false;
+    }
+
+    NodeStore loadedNodes;
+    std::vector<Link> loadedLinks;
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream ss(line);
+        std::string kind;
+        ss >> kind;
+
+        if (kind == "node") {
+            Node node;
+            std::string typeName, value;
+            ss >> node.id >> typeName >> node.position.x >> node.position.y >> node.width
+               >> node.inputSlotId >> node.outputSlotId >> value;
+            if (!ss || !OperationTypeFromString(typeName, node.type)) {
+                std::cerr << "Error: Malformed node record at " << path << ":" << lineNo << std::endl;
+                return false;
+            }
+            node.name = DefaultNodeName(node.type);
+            if (value != "-") {
+                try {
+                    node.value = std::stof(value);
+                } catch (...) {
+                    std::cerr << "Error: Invalid value '" << value << "' at " << path << ":" << lineNo << std::endl;
+                    return false;
+                }
+            }
+
+            std::string trailing;
+            std::getline(ss >> std::ws, trailing);
+            if (!trailing.empty()) {
+                if (node.type == OperationType::Convolution) {
+                    node.kernelText = trailing;
+                } else if (node.type == OperationType::Noise) {
+                    try {
+                        node.seed = static_cast<uint32_t>(std::stoul(trailing));
+                    } catch (...) {
+                        std::cerr << "Error: Invalid seed '" << trailing << "' at " << path << ":" << lineNo << std::endl;
+                        return false;
+                    }
+                } else {
+                    node.imagePath = trailing;
+                }
+            }
+
+            if (loadedNodes.FindById(node.id)) {
+                std::cerr << "Error: Duplicate node id " << node.id << " at " << path << ":" << lineNo << std::endl;
+                return false;
+            }
+            loadedNodes.Insert(std::move(node));
+        } else if (kind == "link") {
+            Link link;
+            ss >> link.id >> link.fromSlot >> link.toSlot;
+            if (!ss) {
+                std::cerr << "Error: Malformed link record at " << path << ":" << lineNo << std::endl;
+                return false;
+            }
+            loadedLinks.push_back(link);
+        } else {
+            std::cerr << "Error: Unknown record '" << kind << "' at " << path << ":" << lineNo << std::endl;
+            return false;
+        }
+    }
+
+    nodes = std::move(loadedNodes);
+    links = std::move(loadedLinks);
+    return true;
+}
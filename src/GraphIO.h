@@ -0,0 +1,18 @@
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include <string>
+#include <vector>
+#include "NodeStore.h"
+
+// Plain-text graph definitions shared by the editor and the batch runner.
+// One record per line:
+//   node <id> <type> <x> <y> <width> <inputSlot> <outputSlot> <value|-> [path]
+//   link <id> <fromSlot> <toSlot>
+const char* OperationTypeToString(OperationType type);
+bool OperationTypeFromString(const std::string& name, OperationType& type);
+
+bool SaveGraph(const std::string& path, const NodeStore& nodes, const std::vector<Link>& links);
+bool LoadGraph(const std::string& path, NodeStore& nodes, std::vector<Link>& links);
+
+#endif // GRAPH_IO_H
@@ -0,0 +1,158 @@
+#include "ImageLoader.h"
+#include "ImageProcessor.h"
+#include "SequenceIO.h"
+#include <algorithm>
+#include <fstream>
+
+// --- Header probing ---
+
+// Reads the frame size from a JPEG's start-of-frame marker, without decoding.
+// False for anything that is not a baseline/progressive JPEG.
+static bool ReadJpegSize(const std::string& path, cv::Size& size) {
+    std::ifstream file(path, std::ios::binary);
+    unsigned char soi[2];
+    if (!file.read(reinterpret_cast<char*>(soi), 2) || soi[0] != 0xFF || soi[1] != 0xD8) return false;
+
+    while (file) {
+        int byte = file.get();
+        if (byte != 0xFF) return false;
+        int marker = file.get();
+        while (marker == 0xFF) marker = file.get(); // Fill bytes
+        if (marker == EOF || marker == 0xD9 || marker == 0xDA) return false; // End of image or scan data before any frame
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) continue; // Markers without a length
+
+        unsigned char lengthBytes[2];
+        if (!file.read(reinterpret_cast<char*>(lengthBytes), 2)) return false;
+        int length = (lengthBytes[0] << 8) | lengthBytes[1];
+        if (length < 2) return false;
+
+        // SOF0-SOF15, except DHT (C4), JPG (C8) and DAC (CC) which share the range
+        bool startOfFrame = marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC;
+        if (startOfFrame) {
+            unsigned char frame[5]; // Precision, height, width
+            if (length < 7 || !file.read(reinterpret_cast<char*>(frame), 5)) return false;
+            size = cv::Size((frame[3] << 8) | frame[4], (frame[1] << 8) | frame[2]);
+            return size.width > 0 && size.height > 0;
+        }
+        file.seekg(length - 2, std::ios::cur);
+    }
+    return false;
+}
+
+// Largest JPEG decode reduction that still leaves the longest side at least maxSize
+static int ReductionFor(cv::Size size, int maxSize) {
+    int longestSide = std::max(size.width, size.height);
+    for (int reduction : {8, 4, 2}) {
+        if ((longestSide + reduction - 1) / reduction >= maxSize) return reduction;
+    }
+    return 1;
+}
+
+DecodedImage ImageLoader::Decode(const std::string& path, int maxSize, int frame) {
+    DecodedImage decoded;
+    decoded.path = path;
+    if (frame >= 0) {
+        // Video codecs have no reduced decode, previews are downscaled later like any other source
+        decoded.image = ReadSequenceFrame(path, frame);
+        decoded.fullSize = decoded.image.size();
+        return decoded;
+    }
+
+    cv::Size fileSize;
+    int reduction = maxSize > 0 && ReadJpegSize(path, fileSize) ? ReductionFor(fileSize, maxSize) : 1;
+    if (reduction == 1) {
+        decoded.image = ImageProcessor::loadImage(path);
+        decoded.fullSize = decoded.image.size();
+        return decoded;
+    }
+
+    int flags = reduction == 8 ? cv::IMREAD_REDUCED_COLOR_8 : reduction == 4 ? cv::IMREAD_REDUCED_COLOR_4 : cv::IMREAD_REDUCED_COLOR_2;
+    decoded.image = cv::imread(path, flags);
+    decoded.reduction = reduction;
+    // imread applies the EXIF orientation, the frame header doesn't
+    bool rotated = (decoded.image.cols > decoded.image.rows) != (fileSize.width > fileSize.height);
+    decoded.fullSize = rotated ? cv::Size(fileSize.height, fileSize.width) : fileSize;
+    return decoded;
+}
+
+// --- Requests ---
+
+void ImageLoader::Request(int key, const std::string& path, int maxSize, int frame) {
+    uint64_t ticket;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ticket = ++nextTicket;
+        slots[key] = Slot{ticket, false, DecodedImage()};
+    }
+
+    pool.submit([this, key, ticket, path, maxSize, frame]() {
+        // Skip requests superseded or cancelled while queued
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto slot = slots.find(key);
+            if (slot == slots.end() || slot->second.ticket != ticket) return;
+        }
+
+        DecodedImage decoded = Decode(path, maxSize, frame);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto slot = slots.find(key);
+        if (slot == slots.end() || slot->second.ticket != ticket) return;
+        slot->second.result = std::move(decoded);
+        slot->second.done = true;
+        finishedKeys.insert(key);
+        finished.notify_all();
+    });
+}
+
+bool ImageLoader::TakeResult(int key, DecodedImage& result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto slot = slots.find(key);
+    if (slot == slots.end() || !slot->second.done) return false;
+    result = std::move(slot->second.result);
+    slots.erase(slot);
+    finishedKeys.erase(key);
+    return true;
+}
+
+DecodedImage ImageLoader::Wait(int key) {
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&]() {
+        auto slot = slots.find(key);
+        return slot == slots.end() || slot->second.done;
+    });
+    DecodedImage result;
+    auto slot = slots.find(key);
+    if (slot != slots.end()) {
+        result = std::move(slot->second.result);
+        slots.erase(slot);
+    }
+    finishedKeys.erase(key);
+    return result;
+}
+
+bool ImageLoader::IsLoading(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto slot = slots.find(key);
+    return slot != slots.end() && !slot->second.done;
+}
+
+void ImageLoader::TakeFinishedKeys(std::vector<int>& keys) {
+    std::lock_guard<std::mutex> lock(mutex);
+    keys.insert(keys.end(), finishedKeys.begin(), finishedKeys.end());
+    finishedKeys.clear();
+}
+
+void ImageLoader::Cancel(int key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.erase(key);
+    finishedKeys.erase(key);
+    finished.notify_all();
+}
+
+void ImageLoader::CancelAll() {
+    std::lock_guard<std::mutex> lock(mutex);
+    slots.clear();
+    finishedKeys.clear();
+    finished.notify_all();
+}
@@ -0,0 +1,70 @@
+#ifndef IMAGE_LOADER_H
+#define IMAGE_LOADER_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "ThreadPool.h"
+
+struct DecodedImage {
+    std::string path;
+    cv::Mat image;      // Empty if the file could not be decoded
+    cv::Size fullSize;  // Size of the image at full resolution
+    int reduction = 1;  // 1, 2, 4 or 8: image is fullSize scaled down by this (rounded up)
+};
+
+// Decodes image files on its own threads so neither the UI thread nor the
+// evaluation pool waits on disk and codecs. Requests are keyed (by node id
+// in the editor, by file index in batch); a new request for a key supersedes
+// the one before it, whose result is dropped.
+class ImageLoader {
+public:
+    explicit ImageLoader(unsigned int threadCount = 2) : pool(threadCount) {}
+
+    // Starts decoding path for key. maxSize > 0 means only a preview no longer
+    // than maxSize is needed, which lets JPEGs decode at 1/2, 1/4 or 1/8 scale
+    // in the DCT domain, several times faster than a full decode. frame >= 0
+    // reads that frame of a video or image sequence (see FrameReader) instead.
+    void Request(int key, const std::string& path, int maxSize = 0, int frame = -1);
+
+    // Hands over the latest request's result once, if it finished
+    bool TakeResult(int key, DecodedImage& result);
+
+    // Blocks until the latest request for key finished and hands its result over.
+    // Returns an empty result if nothing was requested for key.
+    DecodedImage Wait(int key);
+
+    bool IsLoading(int key);
+
+    // Moves the keys whose results finished since the last call into keys, so
+    // the editor only polls nodes that have something to pick up
+    void TakeFinishedKeys(std::vector<int>& keys);
+
+    // Drops the request for key; a decode already running finishes unseen
+    void Cancel(int key);
+    void CancelAll();
+
+    // Synchronous decode, what the workers run
+    static DecodedImage Decode(const std::string& path, int maxSize = 0, int frame = -1);
+
+private:
+    struct Slot {
+        uint64_t ticket = 0;
+        bool done = false;
+        DecodedImage result;
+    };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::map<int, Slot> slots; // Keyed by request key
+    std::set<int> finishedKeys; // Done and not taken yet
+    uint64_t nextTicket = 0;
+    ThreadPool pool; // Last member: destroyed first, so workers finish before the state above goes away
+};
+
+#endif // IMAGE_LOADER_H
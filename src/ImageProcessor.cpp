@@ -1,4 +1,24 @@
 #include "ImageProcessor.h"
+#include "ConvolutionEngine.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+
+// Calls kernel(srcRow, dstRow, count) for every row of an 8-bit image, or once
+// for the whole buffer when both images are continuous. dst must already have
+// src's size and type; it may be src itself.
+template <typename RowKernel>
+static void ForEachRowU8(const cv::Mat& src, cv::Mat& dst, RowKernel kernel) {
+    size_t rowLength = static_cast<size_t>(src.cols) * src.channels();
+    if (src.isContinuous() && dst.isContinuous()) {
+        kernel(src.ptr<uint8_t>(0), dst.ptr<uint8_t>(0), rowLength * src.rows);
+        return;
+    }
+    for (int y = 0; y < src.rows; y++) kernel(src.ptr<uint8_t>(y), dst.ptr<uint8_t>(y), rowLength);
+}
 
 cv::Mat ImageProcessor::loadImage(const std::string& path) {
     return cv::imread(path);
@@ -15,25 +35,314 @@ void ImageProcessor::showImage(const std::string& windowName, const cv::Mat& ima
 
 cv::Mat ImageProcessor::applyBrightness(const cv::Mat& image, int value) {
     cv::Mat result;
-    image.convertTo(result, -1, 1, value);  // alpha = 1, beta = value
+    applyBrightness(image, result, value);
     return result;
 }
 
+void ImageProcessor::applyBrightness(const cv::Mat& image, cv::Mat& dst, int value) {
+    if (image.depth() == CV_8U && image.dims == 2) {
+        // Integer offset, a saturating byte add instead of convertTo's float affine path
+        dst.create(image.size(), image.type());
+        ForEachRowU8(image, dst, [value](const uint8_t* src, uint8_t* out, size_t count) {
+            SimdAddSaturateU8(src, out, count, value);
+        });
+        return;
+    }
+    image.convertTo(dst, -1, 1, value);  // alpha = 1, beta = value
+}
+
 cv::Mat ImageProcessor::applyContrast(const cv::Mat& image, double factor) {
     cv::Mat result;
-    image.convertTo(result, -1, factor, 0);  // alpha = factor, beta = 0
+    applyContrast(image, result, factor);
     return result;
 }
 
+void ImageProcessor::applyContrast(const cv::Mat& image, cv::Mat& dst, double factor) {
+    if (image.depth() == CV_8U && image.dims == 2) {
+        // convertTo scales 8-bit data in single precision, so the SIMD kernel matches it exactly
+        float scale = static_cast<float>(factor);
+        dst.create(image.size(), image.type());
+        ForEachRowU8(image, dst, [scale](const uint8_t* src, uint8_t* out, size_t count) {
+            SimdScaleU8(src, out, count, scale);
+        });
+        return;
+    }
+    image.convertTo(dst, -1, factor, 0);  // alpha = factor, beta = 0
+}
+
 cv::Mat ImageProcessor::applyBlur(const cv::Mat& image, int kernelSize) {
     cv::Mat result;
+    applyBlur(image, result, kernelSize);
+    return result;
+}
+
+void ImageProcessor::applyBlur(const cv::Mat& image, cv::Mat& dst, int kernelSize) {
     kernelSize = (kernelSize / 2) * 2 + 1;
-    cv::GaussianBlur(image, result, cv::Size(kernelSize, kernelSize), 0);
+    if (kernelSize >= fastBlurMinKernelSize) {
+        // GaussianBlur costs O(kernelSize) per pixel, the box cascade a constant
+        applyFastGaussianBlur(image, dst, kernelSize);
+        return;
+    }
+    cv::GaussianBlur(image, dst, cv::Size(kernelSize, kernelSize), 0);
+}
+
+// Widths of `passes` odd box filters whose cascade has the variance of a
+// Gaussian with sigma (Kovesi, "Fast Almost-Gaussian Filtering")
+static std::vector<int> BoxWidthsForGaussian(double sigma, int passes) {
+    double ideal = std::sqrt(12.0 * sigma * sigma / passes + 1.0);
+    int lower = static_cast<int>(std::floor(ideal));
+    if (lower % 2 == 0) lower--;
+    lower = std::max(lower, 1);
+    int upper = lower + 2;
+    double lowerCount = (12.0 * sigma * sigma - passes * lower * lower - 4.0 * passes * lower - 3.0 * passes) / (-4.0 * lower - 4.0);
+    int m = static_cast<int>(std::lround(lowerCount));
+
+    std::vector<int> widths;
+    for (int i = 0; i < passes; i++) widths.push_back(i < m ? lower : upper);
+    return widths;
+}
+
+// Source index for every position of a window sliding over [-radius, length + radius],
+// mirrored at the edges like GaussianBlur's default BORDER_REFLECT_101
+static std::vector<int> ReflectedIndices(int length, int radius) {
+    std::vector<int> indices(length + 2 * radius + 1);
+    for (size_t j = 0; j < indices.size(); j++) {
+        indices[j] = cv::borderInterpolate(static_cast<int>(j) - radius, length, cv::BORDER_REFLECT_101);
+    }
+    return indices;
+}
+
+// Splits [0, count) into chunks of at least minChunk and runs body(begin, end)
+// for each on the shared pool, like the graph's tiles
+static void ParallelRanges(int count, int minChunk, const std::function<void(int, int)>& body) {
+    int chunks = std::max(1, std::min(count / std::max(1, minChunk), static_cast<int>(ThreadPool::shared().size()) * 4));
+    ThreadPool::shared().parallelFor(static_cast<size_t>(chunks), [&](size_t chunk) {
+        int begin = static_cast<int>(static_cast<int64_t>(count) * chunk / chunks);
+        int end = static_cast<int>(static_cast<int64_t>(count) * (chunk + 1) / chunks);
+        if (begin < end) body(begin, end);
+    });
+}
+
+// Box filter of width 2 * radius + 1 along each row of a float image, src and dst must differ
+static void BoxPassRows(const cv::Mat& src, cv::Mat& dst, int radius) {
+    int width = src.cols;
+    int channels = src.channels();
+    std::vector<int> indices = ReflectedIndices(width, radius);
+    float norm = 1.0f / (2 * radius + 1);
+
+    ParallelRanges(src.rows, 16, [&](int firstRow, int endRow) {
+        std::vector<double> sums(channels);
+        for (int y = firstRow; y < endRow; y++) {
+            const float* in = src.ptr<float>(y);
+            float* out = dst.ptr<float>(y);
+            std::fill(sums.begin(), sums.end(), 0.0);
+            for (int j = 0; j <= 2 * radius; j++) {
+                for (int c = 0; c < channels; c++) sums[c] += in[indices[j] * channels + c];
+            }
+            for (int x = 0; x < width; x++) {
+                for (int c = 0; c < channels; c++) out[x * channels + c] = static_cast<float>(sums[c] * norm);
+                if (x + 1 == width) break;
+                const float* entering = in + indices[x + 2 * radius + 1] * channels;
+                const float* leaving = in + indices[x] * channels;
+                for (int c = 0; c < channels; c++) sums[c] += entering[c] - leaving[c];
+            }
+        }
+    });
+}
+
+// Same along columns, each thread slides a window down a vertical strip of whole rows
+static void BoxPassColumns(const cv::Mat& src, cv::Mat& dst, int radius) {
+    int height = src.rows;
+    int rowLength = src.cols * src.channels();
+    std::vector<int> indices = ReflectedIndices(height, radius);
+    float norm = 1.0f / (2 * radius + 1);
+
+    ParallelRanges(rowLength, 256, [&](int stripStart, int stripEnd) {
+        int count = stripEnd - stripStart;
+        std::vector<double> sums(count, 0.0);
+        for (int j = 0; j <= 2 * radius; j++) {
+            const float* in = src.ptr<float>(indices[j]) + stripStart;
+            for (int i = 0; i < count; i++) sums[i] += in[i];
+        }
+        for (int y = 0; y < height; y++) {
+            float* out = dst.ptr<float>(y) + stripStart;
+            for (int i = 0; i < count; i++) out[i] = static_cast<float>(sums[i] * norm);
+            if (y + 1 == height) break;
+            const float* entering = src.ptr<float>(indices[y + 2 * radius + 1]) + stripStart;
+            const float* leaving = src.ptr<float>(indices[y]) + stripStart;
+            for (int i = 0; i < count; i++) sums[i] += entering[i] - leaving[i];
+        }
+    });
+}
+
+void ImageProcessor::applyFastGaussianBlur(const cv::Mat& image, cv::Mat& dst, int kernelSize) {
+    kernelSize = (kernelSize / 2) * 2 + 1;
+    // Same sigma GaussianBlur derives from the kernel size
+    double sigma = 0.3 * ((kernelSize - 1) * 0.5 - 1) + 0.8;
+
+    // Box filters are separable and commute, so all row passes can run before the column passes
+    cv::Mat current, scratch;
+    image.convertTo(current, CV_32F);
+    scratch.create(current.size(), current.type());
+    std::vector<int> widths = BoxWidthsForGaussian(sigma, 3);
+    for (int width : widths) {
+        BoxPassRows(current, scratch, width / 2);
+        std::swap(current, scratch);
+    }
+    for (int width : widths) {
+        BoxPassColumns(current, scratch, width / 2);
+        std::swap(current, scratch);
+    }
+    current.convertTo(dst, image.depth()); // Rounds and saturates back to the input's depth
+}
+
+cv::Mat ImageProcessor::applyConvolution(const cv::Mat& image, const cv::Mat& kernel) {
+    cv::Mat result;
+    applyConvolution(image, result, kernel);
     return result;
 }
 
+void ImageProcessor::applyConvolution(const cv::Mat& image, cv::Mat& dst, const cv::Mat& kernel) {
+    Convolve(image, dst, kernel, ChooseConvolutionMethod(kernel));
+}
+
+cv::Mat ImageProcessor::applyNoise(const cv::Mat& image, double amount) {
+    cv::Mat result;
+    applyNoise(image, result, amount, 0);
+    return result;
+}
+
+// Squares counter-based generator (Widynski 2020): four rounds of squaring
+// and half swapping turn (counter, key) into 32 random bits, no state involved
+static inline uint32_t Squares32(uint64_t counter, uint64_t key) {
+    uint64_t x = counter * key, y = x, z = y + key;
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    x = x * x + z; x = (x >> 32) | (x << 32);
+    x = x * x + y; x = (x >> 32) | (x << 32);
+    return static_cast<uint32_t>((x * x + z) >> 32);
+}
+
+// Spreads a user seed into a key with well mixed bits (splitmix64), odd as the generator expects
+static uint64_t NoiseKey(uint32_t seed) {
+    uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return (z ^ (z >> 31)) | 1;
+}
+
+// Sample i of row y is the high or low half of generator output (y, i / 2),
+// each half mapped to [-amplitude, amplitude]
+template <typename T>
+static void AddNoiseRow(const T* src, T* dst, int y, int first, int count, uint64_t key, float amplitude) {
+    const float scale = 2.0f * amplitude / 65535.0f;
+    uint32_t bits = 0;
+    for (int i = first; i < first + count; i++) {
+        if (i == first || (i & 1) == 0) {
+            uint64_t counter = (static_cast<uint64_t>(static_cast<uint32_t>(y)) << 32) | static_cast<uint32_t>(i >> 1);
+            bits = Squares32(counter, key);
+        }
+        uint32_t sample = (i & 1) ? (bits & 0xffff) : (bits >> 16);
+        float offset = static_cast<float>(sample) * scale - amplitude;
+        dst[i - first] = cv::saturate_cast<T>(static_cast<float>(src[i - first]) + offset);
+    }
+}
+
+template <typename T>
+static void AddNoise(const cv::Mat& src, cv::Mat& dst, float amplitude, uint64_t key, cv::Point origin) {
+    int channels = src.channels();
+    int rowLength = src.cols * channels;
+    cv::parallel_for_(cv::Range(0, src.rows), [&](const cv::Range& range) {
+        for (int y = range.start; y < range.end; y++) {
+            AddNoiseRow(src.ptr<T>(y), dst.ptr<T>(y), origin.y + y, origin.x * channels, rowLength, key, amplitude);
+        }
+    });
+}
+
+void ImageProcessor::applyNoise(const cv::Mat& image, cv::Mat& dst, double amount, uint32_t seed, cv::Point origin) {
+    dst.create(image.size(), image.type());
+    uint64_t key = NoiseKey(seed);
+    float fraction = static_cast<float>(std::max(0.0, amount));
+    switch (image.depth()) {
+        case CV_8U: AddNoise<uchar>(image, dst, fraction * 255.0f, key, origin); break;
+        case CV_16U: AddNoise<ushort>(image, dst, fraction * 65535.0f, key, origin); break;
+        case CV_32F: AddNoise<float>(image, dst, fraction, key, origin); break;
+        default:
+            std::cerr << "Warning: Noise supports 8-bit, 16-bit and float images, passing the image through" << std::endl;
+            if (dst.data != image.data) image.copyTo(dst);
+            break;
+    }
+}
+
 cv::Mat ImageProcessor::blend(const cv::Mat &img1, const cv::Mat &img2, double alpha) {
     cv::Mat res;
-    cv::addWeighted(img1, alpha, img2, 1 - alpha, 0, res);
+    blend(img1, img2, res, alpha);
     return res;
 }
+
+void ImageProcessor::blend(const cv::Mat& img1, const cv::Mat& img2, cv::Mat& dst, double alpha) {
+    bool sameShape = img1.size() == img2.size() && img1.type() == img2.type() && img1.dims == 2;
+    if (!sameShape || img1.depth() != CV_8U) {
+        cv::addWeighted(img1, alpha, img2, 1 - alpha, 0, dst); // Also reports mismatched inputs
+        return;
+    }
+
+    // Walk rows through img1's layout; img2 may have a different stride
+    float weight1 = static_cast<float>(alpha);
+    float weight2 = static_cast<float>(1 - alpha);
+    dst.create(img1.size(), img1.type());
+    size_t rowLength = static_cast<size_t>(img1.cols) * img1.channels();
+    bool continuous = img1.isContinuous() && img2.isContinuous() && dst.isContinuous();
+    int rows = continuous ? 1 : img1.rows;
+    size_t count = continuous ? rowLength * img1.rows : rowLength;
+    for (int y = 0; y < rows; y++) {
+        SimdBlendU8(img1.ptr<uint8_t>(y), img2.ptr<uint8_t>(y), dst.ptr<uint8_t>(y), count, weight1, weight2);
+    }
+}
+
+cv::Mat ImageProcessor::applyPointOps(const cv::Mat& image, const std::vector<PointOp>& ops) {
+    cv::Mat result;
+    applyPointOps(image, result, ops);
+    return result;
+}
+
+void ImageProcessor::applyPointOps(const cv::Mat& image, cv::Mat& result, const std::vector<PointOp>& ops) {
+    if (ops.empty()) {
+        if (result.data != image.data) image.copyTo(result);
+        return;
+    }
+
+    if (image.depth() == CV_8U) {
+        // Run the real single-step kernels over every level, so a fused chain
+        // produces the same bytes as its nodes one by one (they share cache keys)
+        cv::Mat lut(1, 256, CV_8U);
+        for (int level = 0; level < 256; level++) lut.at<uchar>(0, level) = static_cast<uchar>(level);
+        for (const PointOp& op : ops) {
+            if (op.alpha == 1.0) {
+                applyBrightness(lut, lut, static_cast<int>(op.beta));
+            } else if (op.beta == 0.0) {
+                applyContrast(lut, lut, op.alpha);
+            } else {
+                lut.convertTo(lut, -1, op.alpha, op.beta);
+            }
+        }
+        cv::LUT(image, lut, result);
+        return;
+    }
+
+    if (image.depth() == CV_32F || image.depth() == CV_64F) {
+        // No intermediate saturation for floats, the chain collapses to one affine map
+        double alpha = 1.0, beta = 0.0;
+        for (const PointOp& op : ops) {
+            alpha *= op.alpha;
+            beta = beta * op.alpha + op.beta;
+        }
+        image.convertTo(result, -1, alpha, beta);
+        return;
+    }
+
+    // Other integer depths saturate after every step, keep the steps separate
+    image.convertTo(result, -1, ops[0].alpha, ops[0].beta);
+    for (size_t i = 1; i < ops.size(); i++) {
+        result.convertTo(result, -1, ops[i].alpha, ops[i].beta);
+    }
+}
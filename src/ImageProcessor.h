@@ -2,6 +2,16 @@
 #define IMAGE_PROCESSOR_H
 
 #include <opencv2/opencv.hpp>
+#include <vector>
+
+// Per-pixel affine step, dst = src * alpha + beta (saturated like convertTo)
+struct PointOp {
+    double alpha = 1.0;
+    double beta = 0.0;
+
+    static PointOp brightness(int value) { return {1.0, static_cast<double>(value)}; }
+    static PointOp contrast(double factor) { return {factor, 0.0}; }
+};
 
 class ImageProcessor {
 public:
@@ -16,6 +26,51 @@ public:
     static cv::Mat applyNoise(const cv::Mat& image, double amount);
     static cv::Mat applyConvolution(const cv::Mat& image, const cv::Mat& kernel);
     static cv::Mat blend(const cv::Mat& img1, const cv::Mat& img2, double alpha);
+
+    // Applies a chain of point operations in a single pass over the image.
+    // 8-bit images go through a 256-entry LUT built by running the chain on
+    // every input level, which reproduces the per-step saturation exactly.
+    static cv::Mat applyPointOps(const cv::Mat& image, const std::vector<PointOp>& ops);
+
+    // Variants writing into dst. A dst that already has the result's size and
+    // type is reused without reallocating, which lets callers recycle buffers.
+    // Point operations also accept dst being image itself.
+    static void applyBrightness(const cv::Mat& image, cv::Mat& dst, int value);
+    static void applyContrast(const cv::Mat& image, cv::Mat& dst, double factor);
+    static void applyBlur(const cv::Mat& image, cv::Mat& dst, int kernelSize);
+
+    // Correlates image with a CV_32F kernel (anchor at the centre, reflected
+    // borders, like filter2D). The kernel picks its own method, see
+    // ChooseConvolutionMethod in ConvolutionEngine.h.
+    static void applyConvolution(const cv::Mat& image, cv::Mat& dst, const cv::Mat& kernel);
+
+    // Adds uniform noise of up to +-amount of the full range (255 for 8-bit,
+    // 65535 for 16-bit, 1 for float images). Each sample comes from a
+    // counter-based generator keyed by seed and the sample's absolute position,
+    // so the result does not depend on threading or tiling: origin is where
+    // image(0, 0) sits in the full image when image is a tile. Rows are spread
+    // over OpenCV's threads. dst may be image itself.
+    static void applyNoise(const cv::Mat& image, cv::Mat& dst, double amount, uint32_t seed, cv::Point origin = cv::Point());
+
+    // Gaussian approximated by three cascaded box filters of matching variance,
+    // each a running sum, so the cost per pixel does not depend on kernelSize.
+    // Rows and column strips are spread over the shared ThreadPool. Against
+    // cv::GaussianBlur with the same kernel size, 8-bit results stay within
+    // fastBlurMaxError levels on hard edges: a step edge and checkerboards of
+    // 8-64 px squares, for kernel sizes 41-301. make bench checks this and
+    // fails otherwise; smooth or noisy content stays well below.
+    static void applyFastGaussianBlur(const cv::Mat& image, cv::Mat& dst, int kernelSize);
+    static constexpr int fastBlurMaxError = 8;
+
+    // applyBlur switches to applyFastGaussianBlur from this kernel size on
+    static constexpr int fastBlurMinKernelSize = 41;
+    static void applyPointOps(const cv::Mat& image, cv::Mat& dst, const std::vector<PointOp>& ops);
+    static void blend(const cv::Mat& img1, const cv::Mat& img2, cv::Mat& dst, double alpha);
+
+    // In-place point operations, overwrite image (and every Mat sharing its data)
+    static void applyBrightnessInPlace(cv::Mat& image, int value) { applyBrightness(image, image, value); }
+    static void applyContrastInPlace(cv::Mat& image, double factor) { applyContrast(image, image, factor); }
+    static void applyPointOpsInPlace(cv::Mat& image, const std::vector<PointOp>& ops) { applyPointOps(image, image, ops); }
 };
 
 #endif // IMAGE_PROCESSOR_H
\ No newline at end of file
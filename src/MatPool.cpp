@@ -0,0 +1,60 @@
+#include "MatPool.h"
+
+static thread_local uint64_t allocatedOnThisThread = 0;
+
+cv::Mat MatPool::acquire(int rows, int cols, int type) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto bucket = buckets.find(Bucket(rows, cols, type));
+        if (bucket != buckets.end() && !bucket->second.empty()) {
+            cv::Mat image = bucket->second.back();
+            bucket->second.pop_back();
+            size_t bytes = ImageBytes(image);
+            counters.pooledBytes -= bytes;
+            counters.reusedBytes += bytes;
+            counters.hits++;
+            return image;
+        }
+        counters.misses++;
+    }
+    cv::Mat image(rows, cols, type);
+    allocatedOnThisThread += ImageBytes(image);
+    return image;
+}
+
+uint64_t MatPool::threadAllocatedBytes() {
+    return allocatedOnThisThread;
+}
+
+void MatPool::release(cv::Mat& image) {
+    // Views and shared buffers stay with their other owners
+    bool soleOwner = image.u && image.u->refcount == 1 && !image.isSubmatrix() && image.isContinuous();
+    if (!soleOwner || image.dims > 2) {
+        image.release();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    size_t bytes = ImageBytes(image);
+    if (counters.pooledBytes + bytes <= maxPooledBytes) {
+        buckets[Bucket(image.rows, image.cols, image.type())].push_back(image);
+        counters.pooledBytes += bytes;
+    }
+    image.release();
+}
+
+void MatPool::trim() {
+    std::lock_guard<std::mutex> lock(mutex);
+    buckets.clear();
+    counters.pooledBytes = 0;
+}
+
+MatPool::Stats MatPool::stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+MatPool& MatPool::shared() {
+    static MatPool pool;
+    return pool;
+}
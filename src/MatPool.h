@@ -0,0 +1,63 @@
+#ifndef MAT_POOL_H
+#define MAT_POOL_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// Recycles image buffers between graph evaluations. Buffers are bucketed by
+// shape and type, so a released buffer is handed out again as is and
+// cv::Mat::create never reallocates it. Only buffers nobody else references
+// are taken back; anything still shared (e.g. held by the EvalCache) is
+// simply dropped by the caller.
+class MatPool {
+public:
+    explicit MatPool(size_t maxPooledBytes = size_t(256) << 20) : maxPooledBytes(maxPooledBytes) {}
+
+    MatPool(const MatPool&) = delete;
+    MatPool& operator=(const MatPool&) = delete;
+
+    // Returns a buffer of the given shape, recycled if one is available.
+    // The contents are undefined.
+    cv::Mat acquire(int rows, int cols, int type);
+    cv::Mat acquire(cv::Size size, int type) { return acquire(size.height, size.width, type); }
+
+    // Takes the buffer back if image is its only owner, image is empty afterwards
+    void release(cv::Mat& image);
+
+    // Frees every pooled buffer
+    void trim();
+
+    struct Stats {
+        uint64_t hits = 0;         // acquire() served from the pool
+        uint64_t misses = 0;       // acquire() had to allocate
+        uint64_t reusedBytes = 0;  // Bytes served from the pool
+        size_t pooledBytes = 0;    // Bytes currently idle in the pool
+    };
+    Stats stats();
+
+    // Process-wide pool used by the evaluator
+    static MatPool& shared();
+
+    // Bytes newly allocated by acquire() on the calling thread, across all pools.
+    // Differences around a call tell how much that call allocated.
+    static uint64_t threadAllocatedBytes();
+
+private:
+    using Bucket = std::tuple<int, int, int>; // rows, cols, type
+
+    std::mutex mutex;
+    std::map<Bucket, std::vector<cv::Mat>> buckets;
+    size_t maxPooledBytes;
+    Stats counters;
+};
+
+// Bytes of pixel data an image holds
+inline size_t ImageBytes(const cv::Mat& image) {
+    return image.total() * image.elemSize();
+}
+
+#endif // MAT_POOL_H
@@ -0,0 +1,118 @@
+#include "MemoryManager.h"
+#include "MatPool.h"
+#include <algorithm>
+#include <unordered_set>
+
+// Holders are keyed by kind and node id packed into one word
+static uint64_t HolderKey(MemoryManager::Kind kind, int nodeId) {
+    return (static_cast<uint64_t>(kind) << 32) | static_cast<uint32_t>(nodeId);
+}
+
+static MemoryManager::Kind KindOf(uint64_t key) {
+    return static_cast<MemoryManager::Kind>(key >> 32);
+}
+
+static int NodeOf(uint64_t key) {
+    return static_cast<int>(static_cast<uint32_t>(key));
+}
+
+void MemoryManager::Track(Kind kind, int nodeId, const cv::Mat& image) {
+    uint64_t key = HolderKey(kind, nodeId);
+    std::lock_guard<std::mutex> lock(mutex);
+    ReleaseLocked(key);
+    if (image.empty()) return;
+
+    // Views share their parent's allocation, which is what stays alive
+    const void* buffer = image.u ? static_cast<const void*>(image.u) : static_cast<const void*>(image.data);
+    uint64_t bytes = image.u ? image.u->size : ImageBytes(image);
+    Buffer& shared = buffers[buffer];
+    if (shared.holders++ == 0) {
+        shared.bytes = bytes;
+        counters.usedBytes += bytes;
+        counters.peakBytes = std::max(counters.peakBytes, counters.usedBytes);
+    }
+    lruOrder.push_back(key);
+    holders[key] = {buffer, bytes, std::prev(lruOrder.end())};
+    counters.bytesByKind[static_cast<int>(kind)] += bytes;
+}
+
+void MemoryManager::Touch(Kind kind, int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = holders.find(HolderKey(kind, nodeId));
+    if (found != holders.end()) lruOrder.splice(lruOrder.end(), lruOrder, found->second.position);
+}
+
+void MemoryManager::ReleaseLocked(uint64_t key) {
+    auto found = holders.find(key);
+    if (found == holders.end()) return;
+    auto shared = buffers.find(found->second.buffer);
+    if (shared != buffers.end() && --shared->second.holders == 0) {
+        counters.usedBytes -= shared->second.bytes;
+        buffers.erase(shared);
+    }
+    counters.bytesByKind[static_cast<int>(KindOf(key))] -= found->second.bytes;
+    lruOrder.erase(found->second.position);
+    holders.erase(found);
+}
+
+void MemoryManager::Release(Kind kind, int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    ReleaseLocked(HolderKey(kind, nodeId));
+}
+
+void MemoryManager::ReleaseNode(int nodeId) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (int kind = 0; kind < static_cast<int>(Kind::Count); kind++) {
+        ReleaseLocked(HolderKey(static_cast<Kind>(kind), nodeId));
+    }
+}
+
+void MemoryManager::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    lruOrder.clear();
+    holders.clear();
+    buffers.clear();
+    counters.usedBytes = 0;
+    std::fill(std::begin(counters.bytesByKind), std::end(counters.bytesByKind), 0);
+}
+
+void MemoryManager::Enforce(const Evictor& evict) {
+    std::unordered_set<uint64_t> kept;
+    for (;;) {
+        uint64_t key;
+        uint64_t before;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (counters.usedBytes <= budgetBytes) return;
+            before = counters.usedBytes;
+            auto candidate = std::find_if(lruOrder.begin(), lruOrder.end(), [&](uint64_t k) { return !kept.count(k); });
+            if (candidate == lruOrder.end()) return; // Everything left is in use
+            key = *candidate;
+        }
+
+        // A holder sharing its buffer frees nothing by itself, the loop then
+        // moves on until the last holder of that buffer goes as well
+        if (!evict(KindOf(key), NodeOf(key))) {
+            kept.insert(key);
+            continue;
+        }
+        // evict may have released the holder already (EvalCache::Erase does)
+        std::lock_guard<std::mutex> lock(mutex);
+        ReleaseLocked(key);
+        counters.evictions++;
+        if (before > counters.usedBytes) counters.evictedBytes += before - counters.usedBytes;
+    }
+}
+
+void MemoryManager::SetBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    budgetBytes = bytes;
+}
+
+MemoryManager::Stats MemoryManager::stats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats snapshot = counters;
+    snapshot.budgetBytes = budgetBytes;
+    snapshot.holders = holders.size();
+    return snapshot;
+}
@@ -0,0 +1,88 @@
+#ifndef MEMORY_MANAGER_H
+#define MEMORY_MANAGER_H
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <opencv2/opencv.hpp>
+
+// Keeps the images the editor holds between evaluations (decoded sources,
+// displayed results, EvalCache entries) within a byte budget. Each holder is
+// registered under its kind and node id together with the Mat it keeps; a
+// buffer held by several of them, like a display result that is also its
+// target's cache entry, counts once. Once the total exceeds the budget,
+// Enforce evicts holders least recently used first. Nothing evicted is lost:
+// sources are decoded again and results recomputed when next needed.
+// Safe to use from the evaluator's worker threads.
+class MemoryManager {
+public:
+    enum class Kind {
+        Source,        // NodeImages::loadedCvImage of a LoadImage node
+        ReducedSource, // NodeImages::reducedCvImage
+        Display,       // NodeImages::processedImage (and loadedCvImage) of a ProcessDisplay node
+        CachedResult,  // Full-resolution EvalCache entry
+        CachedPreview, // Preview EvalCache entry
+        Count
+    };
+
+    explicit MemoryManager(uint64_t budgetBytes) : budgetBytes(budgetBytes) {}
+
+    MemoryManager(const MemoryManager&) = delete;
+    MemoryManager& operator=(const MemoryManager&) = delete;
+
+    // Records that (kind, nodeId) now holds image, replacing what it held
+    // before, and marks it most recently used. An empty image releases it.
+    void Track(Kind kind, int nodeId, const cv::Mat& image);
+
+    // Marks (kind, nodeId) most recently used, if tracked
+    void Touch(Kind kind, int nodeId);
+
+    void Release(Kind kind, int nodeId);
+    void ReleaseNode(int nodeId); // Every kind
+    void Clear();
+
+    // Drops the image of (kind, nodeId); returns false to keep it, e.g. while it is on screen
+    using Evictor = std::function<bool(Kind kind, int nodeId)>;
+
+    // Evicts least recently used holders until the tracked bytes fit the
+    // budget or every remaining holder was kept. evict runs without the
+    // manager's lock held, so it may release other holders itself.
+    void Enforce(const Evictor& evict);
+
+    void SetBudget(uint64_t bytes);
+
+    struct Stats {
+        uint64_t budgetBytes = 0;
+        uint64_t usedBytes = 0;     // Distinct buffers held right now
+        uint64_t peakBytes = 0;
+        uint64_t evictions = 0;
+        uint64_t evictedBytes = 0;  // Freed by evictions
+        size_t holders = 0;
+        uint64_t bytesByKind[static_cast<int>(Kind::Count)] = {}; // A buffer shared across kinds counts in each
+    };
+    Stats stats();
+
+private:
+    struct Holder {
+        const void* buffer = nullptr;
+        uint64_t bytes = 0;
+        std::list<uint64_t>::iterator position; // In lruOrder
+    };
+    struct Buffer {
+        uint64_t bytes = 0;
+        int holders = 0;
+    };
+
+    void ReleaseLocked(uint64_t key); // Caller holds mutex
+
+    std::mutex mutex;
+    uint64_t budgetBytes;
+    std::list<uint64_t> lruOrder; // Holder keys, front is the least recently used
+    std::unordered_map<uint64_t, Holder> holders;
+    std::unordered_map<const void*, Buffer> buffers;
+    Stats counters;
+};
+
+#endif // MEMORY_MANAGER_H
@@ -0,0 +1,82 @@
+#include "NodeStore.h"
+
+NodeHandle NodeStore::Insert(Node node) {
+    uint32_t index;
+    if (!freeSlots.empty()) {
+        index = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        index = slotCount++;
+        if (index / chunkSize >= slots.size()) {
+            slots.emplace_back(chunkSize);
+            images.emplace_back(chunkSize);
+        }
+    }
+
+    Slot& slot = SlotAt(index);
+    node.handle = {index, slot.generation};
+    slot.node = std::move(node);
+    slot.alive = true;
+    liveCount++;
+    indexById[slot.node.id] = index;
+    if (slot.node.outputSlotId >= 0) indexByOutputSlot[slot.node.outputSlotId] = index;
+    if (slot.node.inputSlotId >= 0) indexByInputSlot[slot.node.inputSlotId] = index;
+    return slot.node.handle;
+}
+
+bool NodeStore::Erase(NodeHandle handle) {
+    if (!Get(handle)) return false;
+
+    Slot& slot = SlotAt(handle.index);
+    indexById.erase(slot.node.id);
+    if (slot.node.outputSlotId >= 0) indexByOutputSlot.erase(slot.node.outputSlotId);
+    if (slot.node.inputSlotId >= 0) indexByInputSlot.erase(slot.node.inputSlotId);
+    slot.node = Node(); // Releases strings and parameters now rather than on reuse
+    slot.alive = false;
+    slot.generation++;
+    images[handle.index / chunkSize][handle.index % chunkSize] = NodeImages();
+    freeSlots.push_back(handle.index);
+    liveCount--;
+    return true;
+}
+
+Node* NodeStore::Get(NodeHandle handle) {
+    if (handle.index >= slotCount) return nullptr;
+    Slot& slot = SlotAt(handle.index);
+    return slot.alive && slot.generation == handle.generation ? &slot.node : nullptr;
+}
+
+const Node* NodeStore::Get(NodeHandle handle) const {
+    if (handle.index >= slotCount) return nullptr;
+    const Slot& slot = SlotAt(handle.index);
+    return slot.alive && slot.generation == handle.generation ? &slot.node : nullptr;
+}
+
+Node* NodeStore::FindById(int nodeId) {
+    auto found = indexById.find(nodeId);
+    return found == indexById.end() ? nullptr : &SlotAt(found->second).node;
+}
+
+const Node* NodeStore::FindById(int nodeId) const {
+    auto found = indexById.find(nodeId);
+    return found == indexById.end() ? nullptr : &SlotAt(found->second).node;
+}
+
+Node* NodeStore::FindByOutputSlot(int slotId) {
+    auto found = indexByOutputSlot.find(slotId);
+    return found == indexByOutputSlot.end() ? nullptr : &SlotAt(found->second).node;
+}
+
+Node* NodeStore::FindByInputSlot(int slotId) {
+    auto found = indexByInputSlot.find(slotId);
+    return found == indexByInputSlot.end() ? nullptr : &SlotAt(found->second).node;
+}
+
+// Erases slot by slot instead of dropping the chunks, so generations keep
+// counting up and handles from before the clear stay stale
+void NodeStore::clear() {
+    for (uint32_t index = 0; index < slotCount; index++) {
+        Slot& slot = SlotAt(index);
+        if (slot.alive) Erase(slot.node.handle);
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef NODE_STORE_H
+#define NODE_STORE_H
+
+#include "_Node.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+
+// Slot map holding the graph's nodes. Nodes live in fixed-size chunks that
+// never move, so Node pointers and references stay valid until that node is
+// erased, however many nodes are added afterwards. Freed slots are reused;
+// NodeHandle generations tell a reused slot from the node that was erased.
+// Node records (ids, slots, type, parameters) and their image payloads sit in
+// two parallel chunk arrays, iterating nodes never pulls cv::Mats into cache.
+//
+// Lookup by handle, id or input/output slot, insertion and erasure are all O(1).
+// Iteration visits live nodes in slot order. Copies are deep (Mats inside
+// share their pixel data), which is how evaluations snapshot the graph.
+class NodeStore {
+    struct Slot {
+        Node node;
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+public:
+    static constexpr uint32_t chunkSize = 256;
+
+    // Stores node, assigns node.handle and returns it. Ids and slots must be unique.
+    NodeHandle Insert(Node node);
+
+    // Frees the node's slot and drops its images. The caller deletes GL
+    // textures first, the store stays GL-free. Returns false for stale handles.
+    bool Erase(NodeHandle handle);
+
+    // nullptr for stale handles or unknown ids/slots
+    Node* Get(NodeHandle handle);
+    const Node* Get(NodeHandle handle) const;
+    Node* FindById(int nodeId);
+    const Node* FindById(int nodeId) const;
+    Node* FindByOutputSlot(int slotId);
+    Node* FindByInputSlot(int slotId);
+
+    // Image payload of a node stored here
+    NodeImages& Images(const Node& node) { return images[node.handle.index / chunkSize][node.handle.index % chunkSize]; }
+    const NodeImages& Images(const Node& node) const { return images[node.handle.index / chunkSize][node.handle.index % chunkSize]; }
+
+    size_t size() const { return liveCount; }
+    bool empty() const { return liveCount == 0; }
+    void clear();
+
+    // Forward iteration over live nodes
+    template <typename Store, typename Value>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        Iterator(Store* store, uint32_t index) : store(store), index(index) { SkipDead(); }
+        Value& operator*() const { return store->SlotAt(index).node; }
+        Value* operator->() const { return &store->SlotAt(index).node; }
+        Iterator& operator++() { index++; SkipDead(); return *this; }
+        bool operator!=(const Iterator& other) const { return index != other.index; }
+        bool operator==(const Iterator& other) const { return index == other.index; }
+
+    private:
+        void SkipDead() {
+            while (index < store->slotCount && !store->SlotAt(index).alive) index++;
+        }
+        Store* store;
+        uint32_t index;
+    };
+    using iterator = Iterator<NodeStore, Node>;
+    using const_iterator = Iterator<const NodeStore, const Node>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, slotCount); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, slotCount); }
+
+private:
+    Slot& SlotAt(uint32_t index) { return slots[index / chunkSize][index % chunkSize]; }
+    const Slot& SlotAt(uint32_t index) const { return slots[index / chunkSize][index % chunkSize]; }
+
+    // Each chunk is allocated at full size up front and never resized, so
+    // growing the outer vectors moves chunk buffers around but never elements
+    std::vector<std::vector<Slot>> slots;
+    std::vector<std::vector<NodeImages>> images;
+    uint32_t slotCount = 0; // Slots handed out so far, live or free
+    size_t liveCount = 0;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<int, uint32_t> indexById;
+    std::unordered_map<int, uint32_t> indexByOutputSlot;
+    std::unordered_map<int, uint32_t> indexByInputSlot;
+};
+
+#endif // NODE_STORE_H
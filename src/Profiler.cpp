@@ -0,0 +1,99 @@
+#include "Profiler.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+int EvalProfile::ThreadIndex() {
+    auto inserted = threads.emplace(std::this_thread::get_id(), static_cast<int>(threads.size()));
+    return inserted.first->second;
+}
+
+double EvalProfile::Microseconds(Clock::time_point time) const {
+    return std::chrono::duration<double, std::micro>(time - origin).count();
+}
+
+void EvalProfile::RecordStep(const std::vector<int>& nodeIds, const std::string& name, Clock::time_point start, NodeProfile profile) {
+    Clock::time_point end = Clock::now();
+    profile.milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+    profile.fused = profile.fused || nodeIds.size() > 1;
+
+    std::string args = "\"nodes\": [";
+    for (size_t i = 0; i < nodeIds.size(); i++) args += (i ? ", " : "") + std::to_string(nodeIds[i]);
+    args += "], \"cache\": \"" + std::string(profile.cacheHit ? "hit" : "miss") + "\", \"result_bytes_allocated\": " +
+            std::to_string(profile.resultBytesAllocated) + ", \"size\": \"" + std::to_string(profile.width) + "x" +
+            std::to_string(profile.height) + "\"";
+
+    std::lock_guard<std::mutex> lock(mutex);
+    profile.thread = ThreadIndex();
+    for (int nodeId : nodeIds) nodes[nodeId] = profile;
+    events.push_back({name, "node", profile.thread, Microseconds(start), Microseconds(end) - Microseconds(start), args});
+}
+
+void EvalProfile::RecordSpan(const std::string& name, const std::string& category, Clock::time_point start) {
+    Clock::time_point end = Clock::now();
+    std::lock_guard<std::mutex> lock(mutex);
+    events.push_back({name, category, ThreadIndex(), Microseconds(start), Microseconds(end) - Microseconds(start), ""});
+}
+
+std::map<int, NodeProfile> EvalProfile::NodeProfiles() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return nodes;
+}
+
+// Node names are user text, control characters must be escaped too
+static std::string EscapeJson(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (c == '\n') {
+            escaped += "\\n";
+        } else if (c == '\t') {
+            escaped += "\\t";
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned char>(c));
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+bool EvalProfile::WriteChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Error: Cannot write trace " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    bool first = true;
+    for (const auto& thread : threads) {
+        out << (first ? "" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << thread.second
+            << ", \"args\": {\"name\": \"evaluator thread " << thread.second << "\"}}";
+        first = false;
+    }
+    for (const TraceEvent& event : events) {
+        out << (first ? "" : ",\n") << "{\"name\": \"" << EscapeJson(event.name) << "\", \"cat\": \"" << event.category
+            << "\", \"ph\": \"X\", \"pid\": 1, \"tid\": " << event.thread << ", \"ts\": " << event.startUs
+            << ", \"dur\": " << event.durationUs << ", \"args\": {" << event.args << "}}";
+        first = false;
+    }
+    out << "\n]}\n";
+    return true;
+}
+
+std::string FormatNodeProfile(const NodeProfile& profile) {
+    char text[96];
+    if (profile.cacheHit) {
+        std::snprintf(text, sizeof(text), "cached | %dx%d", profile.width, profile.height);
+    } else {
+        std::snprintf(text, sizeof(text), "%.1f ms%s | %dx%d | %.1f MB new", profile.milliseconds, profile.fused ? " (fused)" : "",
+                      profile.width, profile.height, profile.resultBytesAllocated / (1024.0 * 1024.0));
+    }
+    return text;
+}
@@ -0,0 +1,72 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// What the evaluator measured for one node during a run
+struct NodeProfile {
+    double milliseconds = 0;      // Wall time of the step that produced the node's result
+    // New result buffers: what MatPool allocated on the step's thread (pool
+    // reuse is free), or a tiled chain's output image. OpenCV's internal
+    // temporaries and buffers allocated by other threads are not seen.
+    uint64_t resultBytesAllocated = 0;
+    int width = 0;                // Output dimensions
+    int height = 0;
+    bool cacheHit = false;
+    bool fused = false;           // Measured together with other nodes (fused or tiled step)
+    int thread = 0;               // Matches the tid of the node's trace event
+};
+
+// Per-run instrumentation, filled in from whatever threads the evaluator uses.
+// Keeps a NodeProfile per node and a timeline that can be written as a Chrome
+// trace_event file (chrome://tracing, Perfetto).
+class EvalProfile {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EvalProfile() : origin(Clock::now()) {}
+
+    EvalProfile(const EvalProfile&) = delete;
+    EvalProfile& operator=(const EvalProfile&) = delete;
+
+    // Records a step that ran on the calling thread from start until now, the
+    // profile is attached to every node in nodeIds
+    void RecordStep(const std::vector<int>& nodeIds, const std::string& name, Clock::time_point start, NodeProfile profile);
+
+    // Records a timeline-only span (e.g. one tile) on the calling thread
+    void RecordSpan(const std::string& name, const std::string& category, Clock::time_point start);
+
+    std::map<int, NodeProfile> NodeProfiles();
+
+    bool WriteChromeTrace(const std::string& path);
+
+private:
+    struct TraceEvent {
+        std::string name;
+        std::string category;
+        int thread = 0;
+        double startUs = 0;
+        double durationUs = 0;
+        std::string args; // JSON object body, may be empty
+    };
+
+    int ThreadIndex(); // Caller holds mutex
+    double Microseconds(Clock::time_point time) const;
+
+    std::mutex mutex;
+    Clock::time_point origin;
+    std::map<int, NodeProfile> nodes; // Keyed by node id
+    std::vector<TraceEvent> events;
+    std::map<std::thread::id, int> threads;
+};
+
+// Short summary for the editor, e.g. "12.3 ms | 1920x1080 | 7.9 MB new"
+std::string FormatNodeProfile(const NodeProfile& profile);
+
+#endif // PROFILER_H
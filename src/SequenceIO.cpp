@@ -0,0 +1,165 @@
+#include "SequenceIO.h"
+#include "ImageProcessor.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <iostream>
+
+namespace fs = std::filesystem;
+
+// --- Paths ---
+
+static std::string LowercaseExtension(const std::string& path) {
+    std::string ext = fs::path(path).extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext;
+}
+
+static bool IsVideoPath(const std::string& path) {
+    std::string ext = LowercaseExtension(path);
+    return ext == ".mp4" || ext == ".mov" || ext == ".avi" || ext == ".mkv";
+}
+
+// Expands the single %d, %4d or %04d in pattern with index. Parsed by hand
+// rather than passed to snprintf, the pattern is user input.
+static bool FormatFramePath(const std::string& pattern, int index, std::string& path) {
+    size_t percent = pattern.find('%');
+    if (percent == std::string::npos) return false;
+    size_t pos = percent + 1;
+    bool zeroPad = pos < pattern.size() && pattern[pos] == '0';
+    if (zeroPad) pos++;
+    size_t width = 0;
+    while (pos < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[pos]))) {
+        width = width * 10 + (pattern[pos++] - '0');
+    }
+    if (pos >= pattern.size() || pattern[pos] != 'd' || pattern.find('%', pos) != std::string::npos || width > 16) return false;
+
+    std::string number = std::to_string(index);
+    if (number.size() < width) number.insert(0, width - number.size(), zeroPad ? '0' : ' ');
+    path = pattern.substr(0, percent) + number + pattern.substr(pos + 1);
+    return true;
+}
+
+bool IsSequenceOutputPath(const std::string& path) {
+    std::string unused;
+    return IsVideoPath(path) || FormatFramePath(path, 0, unused);
+}
+
+// --- FrameReader ---
+
+bool FrameReader::Open(const std::string& path) {
+    capture.release();
+    files.clear();
+    nextFile = 0;
+    isGlob = path.find_first_of("*?") != std::string::npos;
+
+    if (isGlob) {
+        try {
+            cv::glob(path, files, false);
+        } catch (const cv::Exception&) {
+            files.clear();
+        }
+        std::sort(files.begin(), files.end());
+        if (files.empty()) std::cerr << "Error: No files match " << path << std::endl;
+        return !files.empty();
+    }
+
+    if (!capture.open(path)) {
+        std::cerr << "Error: Cannot open sequence " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool FrameReader::IsOpened() const {
+    return isGlob ? !files.empty() : capture.isOpened();
+}
+
+bool FrameReader::Seek(int index) {
+    if (index < 0) return false;
+    if (isGlob) {
+        nextFile = static_cast<size_t>(index);
+        return nextFile < files.size();
+    }
+    if (index == 0 || capture.set(cv::CAP_PROP_POS_FRAMES, index)) return true;
+    // Some backends cannot seek, decode up to the frame instead
+    cv::Mat skipped;
+    for (int i = 0; i < index; i++) {
+        if (!capture.read(skipped)) return false;
+    }
+    return true;
+}
+
+bool FrameReader::Read(cv::Mat& frame) {
+    if (!isGlob) return capture.read(frame) && !frame.empty();
+
+    if (nextFile >= files.size()) return false;
+    const std::string& file = files[nextFile++];
+    frame = ImageProcessor::loadImage(file);
+    if (frame.empty()) std::cerr << "Error: Failed to load frame " << file << std::endl;
+    return !frame.empty();
+}
+
+int FrameReader::FrameCount() const {
+    if (isGlob) return static_cast<int>(files.size());
+    double count = capture.get(cv::CAP_PROP_FRAME_COUNT);
+    return count > 0 ? static_cast<int>(count) : -1;
+}
+
+double FrameReader::Fps() const {
+    return isGlob ? 0.0 : std::max(0.0, capture.get(cv::CAP_PROP_FPS));
+}
+
+cv::Mat ReadSequenceFrame(const std::string& path, int index) {
+    FrameReader reader;
+    cv::Mat frame;
+    if (!reader.Open(path) || !reader.Seek(index) || !reader.Read(frame)) return cv::Mat();
+    return frame;
+}
+
+// --- FrameWriter ---
+
+FrameWriter::FrameWriter(const std::string& path, double fps) : path(path), fps(fps), isVideo(IsVideoPath(path)) {}
+
+bool FrameWriter::Write(const cv::Mat& frame) {
+    if (frame.empty()) return false;
+
+    if (!isVideo) {
+        std::string file;
+        if (!FormatFramePath(path, written, file)) {
+            std::cerr << "Error: " << path << " is neither a video file nor a numbered pattern like frames/%04d.png" << std::endl;
+            return false;
+        }
+        if (written == 0) {
+            std::error_code ec;
+            fs::path parent = fs::path(file).parent_path();
+            if (!parent.empty()) fs::create_directories(parent, ec);
+        }
+        if (!cv::imwrite(file, frame)) {
+            std::cerr << "Error: Cannot write frame " << file << std::endl;
+            return false;
+        }
+        written++;
+        return true;
+    }
+
+    // Video encoders take 8-bit BGR or gray frames
+    cv::Mat converted = frame;
+    if (frame.channels() == 4) cv::cvtColor(frame, converted, cv::COLOR_BGRA2BGR);
+    if (!writer.isOpened()) {
+        std::string ext = LowercaseExtension(path);
+        int fourcc = ext == ".avi" || ext == ".mkv" ? cv::VideoWriter::fourcc('M', 'J', 'P', 'G')
+                                                    : cv::VideoWriter::fourcc('m', 'p', '4', 'v');
+        if (!writer.open(path, fourcc, fps > 0 ? fps : 25.0, converted.size(), converted.channels() != 1)) {
+            std::cerr << "Error: Cannot open video " << path << " for writing" << std::endl;
+            return false;
+        }
+    }
+    writer.write(converted);
+    written++;
+    return true;
+}
+
+void FrameWriter::Close() {
+    if (writer.isOpened()) writer.release();
+}
@@ -0,0 +1,65 @@
+#ifndef SEQUENCE_IO_H
+#define SEQUENCE_IO_H
+
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// Reads the frames of a video or image sequence in order. path is one of
+//   a video file                      clip.mp4
+//   a numbered pattern (printf-style) frames/%04d.png
+//   a glob, matches sorted by name    frames/*.png
+// Video files and numbered patterns go through cv::VideoCapture; glob matches
+// are decoded one file per frame.
+class FrameReader {
+public:
+    bool Open(const std::string& path);
+    bool IsOpened() const;
+
+    // The next Read returns frame index (0-based)
+    bool Seek(int index);
+
+    // False at the end of the sequence or when a frame fails to decode
+    bool Read(cv::Mat& frame);
+
+    int FrameCount() const; // -1 if the container does not tell
+    double Fps() const;     // 0 if unknown
+
+private:
+    cv::VideoCapture capture;
+    std::vector<std::string> files; // Glob matches, empty when reading through capture
+    size_t nextFile = 0;
+    bool isGlob = false;
+};
+
+// Writes frames as a video file (.mp4, .mov, .avi or .mkv) or as numbered
+// images (printf-style pattern such as out/%04d.png). The output is opened on
+// the first frame; later frames must have the same size.
+class FrameWriter {
+public:
+    FrameWriter(const std::string& path, double fps);
+    ~FrameWriter() { Close(); }
+
+    FrameWriter(const FrameWriter&) = delete;
+    FrameWriter& operator=(const FrameWriter&) = delete;
+
+    bool Write(const cv::Mat& frame);
+    void Close();
+    int FramesWritten() const { return written; }
+
+private:
+    std::string path;
+    double fps;
+    bool isVideo;
+    cv::VideoWriter writer;
+    int written = 0;
+};
+
+// True for paths a FrameWriter can write: a video extension or a numbered pattern
+bool IsSequenceOutputPath(const std::string& path);
+
+// Decodes frame index of the sequence at path, empty on failure. Opens and
+// seeks on every call; for single frames, e.g. the editor's preview.
+cv::Mat ReadSequenceFrame(const std::string& path, int index);
+
+#endif // SEQUENCE_IO_H
@@ -0,0 +1,374 @@
+#include "SequencePipeline.h"
+#include "MatPool.h"
+#include "SequenceIO.h"
+#include "SpscQueue.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <thread>
+
+using Clock = std::chrono::steady_clock;
+
+static double SecondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// --- Stage Plumbing ---
+
+// A frame travelling between stages; an empty image marks the end of the sequence
+struct PipelineFrame {
+    int index = -1;
+    cv::Mat image;
+};
+using FrameQueue = SpscQueue<PipelineFrame>;
+
+// Shared by all stages of a run: set on failure, or cancelled from outside
+struct PipelineControl {
+    std::atomic<bool> failed{false};
+    EvalProgress* progress = nullptr;
+
+    bool Stopped() const { return failed || (progress && progress->cancelled); }
+};
+
+// A stage that runs ahead waits for its neighbours: a few spins catch the
+// common case of a frame arriving right away, then it yields and finally
+// sleeps, so waiting stages leave the cores to the bottleneck
+class Backoff {
+public:
+    void Wait() {
+        if (rounds++ < 64) return;
+        if (rounds < 128) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+private:
+    int rounds = 0;
+};
+
+// Blocks until frame is queued; false if the run stopped meanwhile
+static bool Push(FrameQueue& queue, PipelineFrame&& frame, const PipelineControl& control) {
+    Backoff backoff;
+    while (!queue.TryPush(std::move(frame))) {
+        if (control.Stopped()) return false;
+        backoff.Wait();
+    }
+    return true;
+}
+
+static bool Pop(FrameQueue& queue, PipelineFrame& frame, const PipelineControl& control) {
+    Backoff backoff;
+    while (!queue.TryPop(frame)) {
+        if (control.Stopped()) return false;
+        backoff.Wait();
+    }
+    return true;
+}
+
+// Hands frame to every consumer; they share the pixels, and ApplyPlanStep
+// never writes into a buffer someone else holds
+static bool Broadcast(const std::vector<FrameQueue*>& outputs, PipelineFrame frame, const PipelineControl& control) {
+    for (size_t i = 0; i < outputs.size(); i++) {
+        PipelineFrame copy = i + 1 < outputs.size() ? frame : std::move(frame);
+        if (!Push(*outputs[i], std::move(copy), control)) return false;
+    }
+    return true;
+}
+
+static std::string StageName(const PlanStep& step) {
+    if (step.fusedNodes.empty()) return step.node->name + " #" + std::to_string(step.node->id);
+    std::string name = "Fused";
+    for (const Node* fused : step.fusedNodes) name += " #" + std::to_string(fused->id);
+    return name;
+}
+
+// --- Runs ---
+
+// Sources, plan and I/O of one run, shared by the pipelined and the serial loop
+struct SequenceRun {
+    ExecutionPlan plan;
+    int sourceStep = -1;
+    std::vector<int> sinkSteps;  // Step each sink writes
+    std::vector<int> stageOfStep; // Index into stats.stages, -1 for the source step (the reader)
+    FrameReader reader;
+    std::vector<std::unique_ptr<FrameWriter>> writers;
+    int frameCount = -1;          // Frames to read, -1 until the sequence ends
+    bool lengthKnown = false;     // The reader reported its frame count, so running out early is a failure
+};
+
+// Reads frame index of the run. False at the end of the sequence; a frame
+// missing before the known end (e.g. a file that fails to decode) also fails the run.
+static bool ReadFrame(SequenceRun& run, int index, cv::Mat& frame, PipelineControl& control) {
+    if (run.reader.Read(frame)) return true;
+    if (run.lengthKnown && index < run.frameCount) {
+        std::cerr << "Error: Cannot read frame " << index << " of " << run.frameCount << std::endl;
+        control.failed = true;
+    }
+    return false;
+}
+
+static void RunPipelined(SequenceRun& run, const SequenceOptions& options, PipelineControl& control, SequenceStats& stats) {
+    const ExecutionPlan& plan = run.plan;
+    size_t capacity = std::max<size_t>(1, options.queueCapacity);
+
+    // One queue per producer/consumer pair, so every queue has a single thread on each end
+    std::vector<std::unique_ptr<FrameQueue>> queues;
+    std::vector<std::vector<FrameQueue*>> stepOutputs(plan.steps.size());
+    auto connect = [&](int producerStep) {
+        queues.push_back(std::make_unique<FrameQueue>(capacity));
+        stepOutputs[producerStep].push_back(queues.back().get());
+        return queues.back().get();
+    };
+    std::vector<FrameQueue*> stepInputs(plan.steps.size(), nullptr);
+    for (size_t i = 0; i < plan.steps.size(); i++) {
+        if (static_cast<int>(i) != run.sourceStep) stepInputs[i] = connect(plan.steps[i].inputStep);
+    }
+    std::vector<FrameQueue*> sinkInputs;
+    for (int sinkStep : run.sinkSteps) sinkInputs.push_back(connect(sinkStep));
+
+    // Dedicated threads rather than pool tasks: stages block on each other,
+    // which would starve the pool the steps' own kernels run on
+    std::vector<std::thread> threads;
+    threads.emplace_back([&]() {
+        StageStats& stage = stats.stages[0];
+        for (int index = 0; (run.frameCount < 0 || index < run.frameCount) && !control.Stopped(); index++) {
+            Clock::time_point start = Clock::now();
+            PipelineFrame frame{index, cv::Mat()};
+            bool read = ReadFrame(run, index, frame.image, control);
+            stage.busySeconds += SecondsSince(start);
+            if (!read) break;
+            stage.frames++;
+            if (!Broadcast(stepOutputs[run.sourceStep], std::move(frame), control)) return;
+        }
+        if (!control.failed) Broadcast(stepOutputs[run.sourceStep], PipelineFrame(), control);
+    });
+
+    for (size_t i = 0; i < plan.steps.size(); i++) {
+        if (static_cast<int>(i) == run.sourceStep) continue;
+        threads.emplace_back([&, i]() {
+            StageStats& stage = stats.stages[run.stageOfStep[i]];
+            PipelineFrame frame;
+            while (Pop(*stepInputs[i], frame, control)) {
+                if (frame.image.empty()) {
+                    Broadcast(stepOutputs[i], PipelineFrame(), control);
+                    return;
+                }
+                Clock::time_point start = Clock::now();
+                frame.image = ApplyPlanStep(plan.steps[i], frame.image);
+                stage.busySeconds += SecondsSince(start);
+                if (frame.image.empty()) {
+                    std::cerr << "Error: " << stage.name << " failed on frame " << frame.index << std::endl;
+                    control.failed = true;
+                    return;
+                }
+                stage.frames++;
+                if (!Broadcast(stepOutputs[i], std::move(frame), control)) return;
+            }
+        });
+    }
+
+    for (size_t k = 0; k < run.writers.size(); k++) {
+        threads.emplace_back([&, k]() {
+            StageStats& stage = stats.stages[plan.steps.size() + k]; // After the reader and the other steps
+            PipelineFrame frame;
+            while (Pop(*sinkInputs[k], frame, control)) {
+                if (frame.image.empty()) return;
+                Clock::time_point start = Clock::now();
+                bool written = run.writers[k]->Write(frame.image);
+                MatPool::shared().release(frame.image);
+                stage.busySeconds += SecondsSince(start);
+                if (!written) {
+                    control.failed = true;
+                    return;
+                }
+                stage.frames++;
+                if (k == 0 && options.progress) options.progress->completedItems++;
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) thread.join();
+}
+
+// The same stages one frame at a time on the calling thread, the baseline the pipeline is measured against
+static void RunSerial(SequenceRun& run, const SequenceOptions& options, PipelineControl& control, SequenceStats& stats) {
+    const ExecutionPlan& plan = run.plan;
+    // Readers of each step's result, so the last one may take over (and overwrite) the buffer
+    std::vector<int> readers(plan.steps.size(), 0);
+    for (const PlanStep& step : plan.steps) {
+        if (step.inputStep != -1) readers[step.inputStep]++;
+    }
+    for (int sinkStep : run.sinkSteps) readers[sinkStep]++;
+
+    std::vector<cv::Mat> images(plan.steps.size());
+    std::vector<int> remaining;
+    auto take = [&](int step) {
+        if (--remaining[step] == 0) return std::move(images[step]);
+        return cv::Mat(images[step]);
+    };
+
+    for (int index = 0; (run.frameCount < 0 || index < run.frameCount) && !control.Stopped(); index++) {
+        Clock::time_point start = Clock::now();
+        cv::Mat frame;
+        bool read = ReadFrame(run, index, frame, control);
+        stats.stages[0].busySeconds += SecondsSince(start);
+        if (!read) break;
+        stats.stages[0].frames++;
+        images[run.sourceStep] = std::move(frame);
+        remaining = readers;
+
+        // Steps are in topological order, producers first
+        for (size_t i = 0; i < plan.steps.size(); i++) {
+            if (static_cast<int>(i) == run.sourceStep) continue;
+            StageStats& stage = stats.stages[run.stageOfStep[i]];
+            cv::Mat input = take(plan.steps[i].inputStep);
+            start = Clock::now();
+            images[i] = ApplyPlanStep(plan.steps[i], input);
+            stage.busySeconds += SecondsSince(start);
+            if (images[i].empty()) {
+                std::cerr << "Error: " << stage.name << " failed on frame " << index << std::endl;
+                control.failed = true;
+                return;
+            }
+            stage.frames++;
+        }
+
+        for (size_t k = 0; k < run.writers.size(); k++) {
+            StageStats& stage = stats.stages[plan.steps.size() + k];
+            cv::Mat output = take(run.sinkSteps[k]);
+            start = Clock::now();
+            bool written = run.writers[k]->Write(output);
+            MatPool::shared().release(output);
+            stage.busySeconds += SecondsSince(start);
+            if (!written) {
+                control.failed = true;
+                return;
+            }
+            stage.frames++;
+        }
+        if (options.progress) options.progress->completedItems++;
+    }
+}
+
+bool RunSequencePipeline(const std::vector<int>& sinkIds, NodeStore& nodes, std::vector<Link>& links,
+                         const SequenceOptions& options, SequenceStats& stats) {
+    stats = SequenceStats();
+    SequenceRun run;
+
+    // Sinks read the node linked to their input, like ProcessDisplay nodes
+    std::vector<int> targetIds;
+    std::vector<const Node*> sinks;
+    for (int sinkId : sinkIds) {
+        Node* sink = nodes.FindById(sinkId);
+        if (!sink || sink->type != OperationType::SequenceSink) {
+            std::cerr << "Error: Node " << sinkId << " is not a Sequence Output node" << std::endl;
+            return false;
+        }
+        if (!IsSequenceOutputPath(sink->imagePath.value_or(""))) {
+            std::cerr << "Error: Sequence Output node " << sinkId << " needs a video file (.mp4, .mov, .avi, .mkv)"
+                      << " or a numbered pattern like frames/%04d.png" << std::endl;
+            return false;
+        }
+        const Link* inputLink = FindLinkConnectedToInput(sink->inputSlotId, links);
+        Node* producer = inputLink ? FindNodeByOutputAttr(inputLink->fromSlot, nodes) : nullptr;
+        if (!producer) {
+            std::cerr << "Error: Sequence Output node " << sinkId << " is not connected." << std::endl;
+            return false;
+        }
+        sinks.push_back(sink);
+        targetIds.push_back(producer->id);
+    }
+    if (sinks.empty()) return false;
+
+    run.plan = CompileGraph(targetIds, nodes, links);
+    if (!run.plan.valid) {
+        std::cerr << "Error: " << run.plan.error << std::endl;
+        return false;
+    }
+    run.sinkSteps = run.plan.targetSteps;
+
+    // Every node has one input, so the plan is a tree and its only step without an input must be the sequence
+    for (size_t i = 0; i < run.plan.steps.size(); i++) {
+        const PlanStep& step = run.plan.steps[i];
+        if (step.inputStep != -1) continue;
+        if (step.node->type != OperationType::SequenceSource) {
+            std::cerr << "Error: Node " << step.node->id << " (" << step.node->name << ") feeds a Sequence Output"
+                      << " without reading from a Sequence Source" << std::endl;
+            return false;
+        }
+        if (run.sourceStep != -1) {
+            std::cerr << "Error: Sequence outputs rendered together must share one Sequence Source" << std::endl;
+            return false;
+        }
+        run.sourceStep = static_cast<int>(i);
+    }
+    if (run.sourceStep == -1) return false;
+    if (std::find(run.sinkSteps.begin(), run.sinkSteps.end(), run.sourceStep) != run.sinkSteps.end()) {
+        std::cerr << "Error: A Sequence Output reads its Sequence Source directly, there is nothing to process" << std::endl;
+        return false;
+    }
+
+    const Node* source = run.plan.steps[run.sourceStep].node;
+    std::string sourcePath = source->imagePath.value_or("");
+    if (!run.reader.Open(sourcePath)) return false;
+    run.frameCount = run.reader.FrameCount();
+    run.lengthKnown = run.frameCount >= 0;
+    if (options.maxFrames >= 0 && (run.frameCount < 0 || options.maxFrames < run.frameCount)) run.frameCount = options.maxFrames;
+    for (const Node* sink : sinks) run.writers.push_back(std::make_unique<FrameWriter>(sink->imagePath.value(), run.reader.Fps()));
+
+    // Stage order: reader, the steps in plan order, then the writers
+    stats.stages.push_back({"Read " + sourcePath});
+    run.stageOfStep.assign(run.plan.steps.size(), -1);
+    for (size_t i = 0; i < run.plan.steps.size(); i++) {
+        if (static_cast<int>(i) == run.sourceStep) continue;
+        run.stageOfStep[i] = static_cast<int>(stats.stages.size());
+        stats.stages.push_back({StageName(run.plan.steps[i])});
+    }
+    for (const Node* sink : sinks) stats.stages.push_back({"Write " + sink->imagePath.value()});
+
+    PipelineControl control;
+    control.progress = options.progress;
+    if (options.progress) options.progress->totalItems = std::max(0, run.frameCount);
+    std::cout << "Sequence: " << (options.pipelined ? "pipelining " : "running ") << sourcePath << " through "
+              << stats.stages.size() << " stages into " << sinks.size() << " output(s)" << std::endl;
+
+    Clock::time_point start = Clock::now();
+    if (options.pipelined) {
+        RunPipelined(run, options, control, stats);
+    } else {
+        RunSerial(run, options, control, stats);
+    }
+    for (auto& writer : run.writers) writer->Close();
+    stats.seconds = SecondsSince(start);
+    stats.frames = stats.stages[0].frames;
+    return !control.Stopped();
+}
+
+// --- Reporting ---
+
+const StageStats* SequenceStats::Bottleneck() const {
+    auto busiest = std::max_element(stages.begin(), stages.end(), [](const StageStats& a, const StageStats& b) {
+        return a.busySeconds < b.busySeconds;
+    });
+    return busiest == stages.end() || busiest->frames == 0 ? nullptr : &*busiest;
+}
+
+std::string FormatSequenceStats(const SequenceStats& stats) {
+    std::ostringstream out;
+    out.setf(std::ios::fixed);
+    out.precision(1);
+    out << stats.frames << " frames in " << stats.seconds << " s";
+    if (stats.seconds > 0) out << " (" << stats.frames / stats.seconds << " fps)";
+    const StageStats* bottleneck = stats.Bottleneck();
+    for (const StageStats& stage : stats.stages) {
+        out << "\n  " << stage.name << ": ";
+        if (stage.frames > 0) out << stage.busySeconds * 1000.0 / stage.frames << " ms/frame";
+        else out << "-";
+        if (&stage == bottleneck) out << " (slowest)";
+    }
+    return out.str();
+}
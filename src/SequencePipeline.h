@@ -0,0 +1,48 @@
+#ifndef SEQUENCE_PIPELINE_H
+#define SEQUENCE_PIPELINE_H
+
+#include <string>
+#include <vector>
+#include "utils.h"
+
+// Per-run settings of RunSequencePipeline
+struct SequenceOptions {
+    bool pipelined = true;    // false runs every stage on a frame before reading the next, for comparison
+    size_t queueCapacity = 4; // Frames buffered between two stages, bounds the frames in flight
+    int maxFrames = -1;       // Stops after this many frames, -1 for the whole sequence
+    EvalProgress* progress = nullptr; // Optional; items are frames written, cancelled stops the run
+};
+
+// Time one stage spent working versus waiting on its neighbours
+struct StageStats {
+    std::string name;
+    int frames = 0;
+    double busySeconds = 0.0;
+};
+
+struct SequenceStats {
+    int frames = 0;     // Frames read from the source
+    double seconds = 0.0;
+    std::vector<StageStats> stages; // Reader, one per plan step, then one writer per sink
+
+    // The stage the others wait on, nullptr if nothing ran
+    const StageStats* Bottleneck() const;
+};
+
+// Streams every frame of a SequenceSource through the graph into the given
+// SequenceSink nodes (video files or numbered images). The graph is compiled
+// once like ProcessGraphTargets, point operations fused, and each plan step
+// becomes a stage on its own thread: while the writer encodes frame n, the
+// steps before it work on frames n+1, n+2, ... and the reader decodes further
+// ahead. Stages hand frames over through bounded lock-free queues, so
+// throughput approaches that of the slowest stage instead of the sum of all,
+// and memory stays bounded by the queue capacity. Every sink must be fed from
+// the same SequenceSource. Frames run at full resolution and bypass the
+// EvalCache. Returns false on compile errors, I/O failures or cancellation.
+bool RunSequencePipeline(const std::vector<int>& sinkIds, NodeStore& nodes, std::vector<Link>& links,
+                         const SequenceOptions& options, SequenceStats& stats);
+
+// One line per stage with its ms/frame, marking the bottleneck
+std::string FormatSequenceStats(const SequenceStats& stats);
+
+#endif // SEQUENCE_PIPELINE_H
@@ -0,0 +1,246 @@
+#include "SimdKernels.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define SIMD_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// --- Scalar ---
+
+static inline uint8_t SaturateU8(int value) {
+    return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+}
+
+// lrintf rounds to nearest even in the default rounding mode, like cvRound
+static inline uint8_t RoundSaturateU8(float value) {
+    if (!(value > 0.0f)) return 0; // Also maps NaN to 0
+    if (value >= 255.0f) return 255;
+    return static_cast<uint8_t>(std::lrintf(value));
+}
+
+static void AddSaturateScalar(const uint8_t* src, uint8_t* dst, size_t count, int value) {
+    for (size_t i = 0; i < count; i++) dst[i] = SaturateU8(src[i] + value);
+}
+
+static void ScaleScalar(const uint8_t* src, uint8_t* dst, size_t count, float factor) {
+    for (size_t i = 0; i < count; i++) dst[i] = RoundSaturateU8(static_cast<float>(src[i]) * factor);
+}
+
+static void BlendScalar(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t count, float alpha, float beta) {
+    for (size_t i = 0; i < count; i++) {
+        float weightedA = static_cast<float>(a[i]) * alpha;
+        float weightedB = static_cast<float>(b[i]) * beta;
+        dst[i] = RoundSaturateU8(weightedA + weightedB);
+    }
+}
+
+// --- AVX2 (compiled for the target attribute, only called after a CPU check) ---
+
+#ifdef SIMD_HAVE_AVX2
+__attribute__((target("avx2")))
+static void AddSaturateAVX2(const uint8_t* src, uint8_t* dst, size_t count, int value) {
+    __m256i offset = _mm256_set1_epi8(static_cast<char>(std::min(std::abs(value), 255)));
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256i pixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        pixels = value >= 0 ? _mm256_adds_epu8(pixels, offset) : _mm256_subs_epu8(pixels, offset);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), pixels);
+    }
+    AddSaturateScalar(src + i, dst + i, count - i, value);
+}
+
+// Widens 8 bytes to floats
+__attribute__((target("avx2")))
+static inline __m256 LoadU8AsFloat(const uint8_t* src) {
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+}
+
+// Clamps 8 floats to [0, 255] first: cvtps_epi32 turns values of 2^31 and
+// above (and inf) into INT_MIN, which would pack to 0 instead of saturating.
+// max_ps returns its second operand for NaN, so NaN becomes 0 like the scalar path.
+__attribute__((target("avx2")))
+static inline __m256 ClampToU8Range(__m256 f) {
+    return _mm256_min_ps(_mm256_max_ps(f, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+}
+
+// Rounds 4 x 8 floats to nearest even and packs them with saturation into 32 bytes
+__attribute__((target("avx2")))
+static inline __m256i PackFloatsToU8(__m256 f0, __m256 f1, __m256 f2, __m256 f3) {
+    f0 = ClampToU8Range(f0);
+    f1 = ClampToU8Range(f1);
+    f2 = ClampToU8Range(f2);
+    f3 = ClampToU8Range(f3);
+    __m256i words01 = _mm256_packs_epi32(_mm256_cvtps_epi32(f0), _mm256_cvtps_epi32(f1));
+    __m256i words23 = _mm256_packs_epi32(_mm256_cvtps_epi32(f2), _mm256_cvtps_epi32(f3));
+    __m256i bytes = _mm256_packus_epi16(words01, words23);
+    // The packs work per 128-bit lane, put the dwords back in source order
+    return _mm256_permutevar8x32_epi32(bytes, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+__attribute__((target("avx2")))
+static void ScaleAVX2(const uint8_t* src, uint8_t* dst, size_t count, float factor) {
+    __m256 scale = _mm256_set1_ps(factor);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256 f[4];
+        for (int k = 0; k < 4; k++) f[k] = _mm256_mul_ps(LoadU8AsFloat(src + i + 8 * k), scale);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), PackFloatsToU8(f[0], f[1], f[2], f[3]));
+    }
+    ScaleScalar(src + i, dst + i, count - i, factor);
+}
+
+__attribute__((target("avx2")))
+static void BlendAVX2(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t count, float alpha, float beta) {
+    __m256 weightA = _mm256_set1_ps(alpha);
+    __m256 weightB = _mm256_set1_ps(beta);
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m256 f[4];
+        for (int k = 0; k < 4; k++) {
+            __m256 weightedA = _mm256_mul_ps(LoadU8AsFloat(a + i + 8 * k), weightA);
+            __m256 weightedB = _mm256_mul_ps(LoadU8AsFloat(b + i + 8 * k), weightB);
+            f[k] = _mm256_add_ps(weightedA, weightedB);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), PackFloatsToU8(f[0], f[1], f[2], f[3]));
+    }
+    BlendScalar(a + i, b + i, dst + i, count - i, alpha, beta);
+}
+#endif
+
+// --- NEON (baseline on AArch64) ---
+
+#ifdef SIMD_HAVE_NEON
+static void AddSaturateNEON(const uint8_t* src, uint8_t* dst, size_t count, int value) {
+    uint8x16_t offset = vdupq_n_u8(static_cast<uint8_t>(std::min(std::abs(value), 255)));
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        uint8x16_t pixels = vld1q_u8(src + i);
+        pixels = value >= 0 ? vqaddq_u8(pixels, offset) : vqsubq_u8(pixels, offset);
+        vst1q_u8(dst + i, pixels);
+    }
+    AddSaturateScalar(src + i, dst + i, count - i, value);
+}
+
+// Widens 16 bytes to 4 x 4 floats
+static inline void LoadU8AsFloat(const uint8_t* src, float32x4_t f[4]) {
+    uint8x16_t bytes = vld1q_u8(src);
+    uint16x8_t low = vmovl_u8(vget_low_u8(bytes));
+    uint16x8_t high = vmovl_u8(vget_high_u8(bytes));
+    f[0] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(low)));
+    f[1] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(low)));
+    f[2] = vcvtq_f32_u32(vmovl_u16(vget_low_u16(high)));
+    f[3] = vcvtq_f32_u32(vmovl_u16(vget_high_u16(high)));
+}
+
+// Rounds to nearest even and narrows with saturation
+static inline uint8x16_t PackFloatsToU8(const float32x4_t f[4]) {
+    int16x8_t low = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(f[0])), vqmovn_s32(vcvtnq_s32_f32(f[1])));
+    int16x8_t high = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(f[2])), vqmovn_s32(vcvtnq_s32_f32(f[3])));
+    return vcombine_u8(vqmovun_s16(low), vqmovun_s16(high));
+}
+
+static void ScaleNEON(const uint8_t* src, uint8_t* dst, size_t count, float factor) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        float32x4_t f[4];
+        LoadU8AsFloat(src + i, f);
+        for (int k = 0; k < 4; k++) f[k] = vmulq_n_f32(f[k], factor);
+        vst1q_u8(dst + i, PackFloatsToU8(f));
+    }
+    ScaleScalar(src + i, dst + i, count - i, factor);
+}
+
+static void BlendNEON(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t count, float alpha, float beta) {
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        float32x4_t fa[4], fb[4];
+        LoadU8AsFloat(a + i, fa);
+        LoadU8AsFloat(b + i, fb);
+        for (int k = 0; k < 4; k++) fa[k] = vaddq_f32(vmulq_n_f32(fa[k], alpha), vmulq_n_f32(fb[k], beta));
+        vst1q_u8(dst + i, PackFloatsToU8(fa));
+    }
+    BlendScalar(a + i, b + i, dst + i, count - i, alpha, beta);
+}
+#endif
+
+// --- Dispatch ---
+
+SimdLevel DetectedSimdLevel() {
+#if defined(SIMD_HAVE_AVX2)
+    static const SimdLevel detected = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2 : SimdLevel::Scalar;
+    return detected;
+#elif defined(SIMD_HAVE_NEON)
+    return SimdLevel::NEON;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+static std::atomic<int> activeLevel{-1}; // -1 until first use
+
+SimdLevel ActiveSimdLevel() {
+    int level = activeLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = static_cast<int>(DetectedSimdLevel());
+        activeLevel.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<SimdLevel>(level);
+}
+
+void SetSimdLevel(SimdLevel level) {
+    if (level != SimdLevel::Scalar) level = DetectedSimdLevel();
+    activeLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+const char* SimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::NEON: return "neon";
+        default: return "scalar";
+    }
+}
+
+void SimdAddSaturateU8(const uint8_t* src, uint8_t* dst, size_t count, int value) {
+    switch (ActiveSimdLevel()) {
+#ifdef SIMD_HAVE_AVX2
+        case SimdLevel::AVX2: AddSaturateAVX2(src, dst, count, value); return;
+#endif
+#ifdef SIMD_HAVE_NEON
+        case SimdLevel::NEON: AddSaturateNEON(src, dst, count, value); return;
+#endif
+        default: AddSaturateScalar(src, dst, count, value); return;
+    }
+}
+
+void SimdScaleU8(const uint8_t* src, uint8_t* dst, size_t count, float factor) {
+    switch (ActiveSimdLevel()) {
+#ifdef SIMD_HAVE_AVX2
+        case SimdLevel::AVX2: ScaleAVX2(src, dst, count, factor); return;
+#endif
+#ifdef SIMD_HAVE_NEON
+        case SimdLevel::NEON: ScaleNEON(src, dst, count, factor); return;
+#endif
+        default: ScaleScalar(src, dst, count, factor); return;
+    }
+}
+
+void SimdBlendU8(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t count, float alpha, float beta) {
+    switch (ActiveSimdLevel()) {
+#ifdef SIMD_HAVE_AVX2
+        case SimdLevel::AVX2: BlendAVX2(a, b, dst, count, alpha, beta); return;
+#endif
+#ifdef SIMD_HAVE_NEON
+        case SimdLevel::NEON: BlendNEON(a, b, dst, count, alpha, beta); return;
+#endif
+        default: BlendScalar(a, b, dst, count, alpha, beta); return;
+    }
+}
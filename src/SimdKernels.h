@@ -0,0 +1,38 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Vectorised 8-bit kernels behind ImageProcessor's point operations. The
+// best implementation for the running CPU is picked on first use: AVX2 on
+// x86-64 when the CPU has it, NEON on 64-bit ARM, plain C++ otherwise.
+// Every variant produces the same bytes as the scalar one.
+enum class SimdLevel {
+    Scalar,
+    AVX2,
+    NEON
+};
+
+// Best level the CPU and the build support
+SimdLevel DetectedSimdLevel();
+
+// Level the kernels currently run with
+SimdLevel ActiveSimdLevel();
+
+// Restricts the kernels to level (clamped to the detected one), for benchmarks
+void SetSimdLevel(SimdLevel level);
+
+const char* SimdLevelName(SimdLevel level);
+
+// dst[i] = saturate(src[i] + value), exact integer arithmetic
+void SimdAddSaturateU8(const uint8_t* src, uint8_t* dst, size_t count, int value);
+
+// dst[i] = saturate(round(src[i] * factor)), single-precision product rounded
+// to nearest even like convertTo, so results match OpenCV bit for bit
+void SimdScaleU8(const uint8_t* src, uint8_t* dst, size_t count, float factor);
+
+// dst[i] = saturate(round(a[i] * alpha + b[i] * beta)) like addWeighted
+void SimdBlendU8(const uint8_t* a, const uint8_t* b, uint8_t* dst, size_t count, float alpha, float beta);
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,53 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded lock-free queue for exactly one producer thread and one consumer
+// thread. A ring of capacity + 1 slots; the producer only writes tail and the
+// consumer only writes head, each publishing with a release store that the
+// other side reads with acquire, so no slot is ever touched by both at once.
+// The indices sit on separate cache lines to keep the two threads from
+// invalidating each other's line on every operation.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) : slots(capacity + 1) {}
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // Producer side, false if the queue is full
+    bool TryPush(T&& value) {
+        size_t tail = tailIndex.load(std::memory_order_relaxed);
+        size_t next = Next(tail);
+        if (next == headIndex.load(std::memory_order_acquire)) return false;
+        slots[tail] = std::move(value);
+        tailIndex.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, false if the queue is empty
+    bool TryPop(T& value) {
+        size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailIndex.load(std::memory_order_acquire)) return false;
+        value = std::move(slots[head]);
+        slots[head] = T(); // Don't keep the moved-from payload (e.g. a Mat's buffer) alive in the ring
+        headIndex.store(Next(head), std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return slots.size() - 1; }
+
+private:
+    size_t Next(size_t index) const { return index + 1 == slots.size() ? 0 : index + 1; }
+
+    std::vector<T> slots;
+    alignas(64) std::atomic<size_t> headIndex{0}; // Next slot to pop, written by the consumer
+    alignas(64) std::atomic<size_t> tailIndex{0}; // Next slot to push, written by the producer
+};
+
+#endif // SPSC_QUEUE_H
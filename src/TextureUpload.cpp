@@ -0,0 +1,155 @@
+// Core profile header, the upload path needs GL 3.x entry points (buffer mapping, swizzles)
+#define GLFW_INCLUDE_GLCOREARB
+#define GL_GLEXT_PROTOTYPES
+#include "TextureUpload.h"
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+// What a texture was allocated with, so later uploads can reuse it
+struct TextureStorage {
+    int width = 0;
+    int height = 0;
+    GLenum internalFormat = 0;
+    bool mipmapped = false;
+    GLuint pixelBuffer = 0; // Staging buffer for asynchronous uploads
+};
+
+static std::unordered_map<GLuint, TextureStorage> textureStorage;
+
+// Maps a cv::Mat layout onto GL formats, returns false for unsupported layouts.
+// Storage keeps the Mat's depth, so 16-bit and float images are not cut to
+// 8 bits on the GPU; float images show their 0..1 range.
+static bool GetUploadFormat(const cv::Mat& image, GLenum& internalFormat, GLenum& format, GLenum& type) {
+    // Internal formats for 1, 3 and 4 channels
+    static const GLenum formats8U[3] = {GL_R8, GL_RGB8, GL_RGBA8};
+    static const GLenum formats16U[3] = {GL_R16, GL_RGB16, GL_RGBA16};
+    static const GLenum formats32F[3] = {GL_R32F, GL_RGB32F, GL_RGBA32F};
+    const GLenum* internalFormats;
+    switch (image.depth()) {
+        case CV_8U: type = GL_UNSIGNED_BYTE; internalFormats = formats8U; break;
+        case CV_16U: type = GL_UNSIGNED_SHORT; internalFormats = formats16U; break;
+        case CV_32F: type = GL_FLOAT; internalFormats = formats32F; break;
+        default: return false;
+    }
+
+    // OpenCV stores colour as BGR(A), GL reads that order directly
+    switch (image.channels()) {
+        case 1: internalFormat = internalFormats[0]; format = GL_RED; break;
+        case 3: internalFormat = internalFormats[1]; format = GL_BGR; break;
+        case 4: internalFormat = internalFormats[2]; format = GL_BGRA; break;
+        default: return false;
+    }
+    return true;
+}
+
+void DeleteTexture(unsigned int& textureId) {
+    if (textureId == 0) return;
+
+    auto storage = textureStorage.find(textureId);
+    if (storage != textureStorage.end()) {
+        if (storage->second.pixelBuffer != 0) glDeleteBuffers(1, &storage->second.pixelBuffer);
+        textureStorage.erase(storage);
+    }
+    glDeleteTextures(1, &textureId);
+    textureId = 0;
+}
+
+static bool UploadTexture(const cv::Mat& image, unsigned int& textureId, bool mipmapped) {
+    if (image.empty()) {
+        return false;
+    }
+
+    GLenum internalFormat, format, type;
+    if (!GetUploadFormat(image, internalFormat, format, type)) {
+        // Handle other cases or return false if unsupported format
+        DeleteTexture(textureId);
+        return false;
+    }
+
+    auto storage = textureStorage.find(textureId);
+    bool reuse = textureId != 0 && storage != textureStorage.end()
+        && storage->second.width == image.cols && storage->second.height == image.rows
+        && storage->second.internalFormat == internalFormat && storage->second.mipmapped == mipmapped;
+
+    if (!reuse) {
+        // New size or format, allocate fresh storage
+        DeleteTexture(textureId);
+        glGenTextures(1, &textureId);
+        glBindTexture(GL_TEXTURE_2D, textureId);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // Avoid border artifacts
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        if (format == GL_RED) {
+            // Show single-channel images as gray instead of red
+            GLint swizzle[4] = {GL_RED, GL_RED, GL_RED, GL_ONE};
+            glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        }
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, image.cols, image.rows, 0, format, type, nullptr);
+
+        TextureStorage created;
+        created.width = image.cols;
+        created.height = image.rows;
+        created.internalFormat = internalFormat;
+        created.mipmapped = mipmapped;
+        glGenBuffers(1, &created.pixelBuffer);
+        storage = textureStorage.emplace(textureId, created).first;
+    } else {
+        glBindTexture(GL_TEXTURE_2D, textureId);
+    }
+
+    // Stage the pixels in a freshly orphaned buffer: the copy into it is the
+    // only synchronous part, the transfer to the texture runs asynchronously
+    size_t rowBytes = image.cols * image.elemSize();
+    size_t totalBytes = rowBytes * image.rows;
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, storage->second.pixelBuffer);
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, totalBytes, nullptr, GL_STREAM_DRAW);
+    void* staging = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, totalBytes, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+
+    if (staging) {
+        if (image.isContinuous()) {
+            memcpy(staging, image.data, totalBytes);
+        } else {
+            for (int row = 0; row < image.rows; row++) {
+                memcpy(static_cast<unsigned char*>(staging) + row * rowBytes, image.ptr(row), rowBytes);
+            }
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.cols, image.rows, format, type, nullptr);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    } else {
+        // Mapping failed, upload straight from the Mat (blocking)
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(image.step[0] / image.elemSize()));
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, image.cols, image.rows, format, type, image.data);
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (mipmapped) glGenerateMipmap(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture
+
+    return true;
+}
+
+bool CreateOrUpdateTexture(const cv::Mat& image, unsigned int& textureId) {
+    return UploadTexture(image, textureId, false);
+}
+
+cv::Mat MakeThumbnail(const cv::Mat& image, int maxWidth) {
+    if (image.empty() || image.cols <= maxWidth) return image;
+    double scale = static_cast<double>(maxWidth) / image.cols;
+    cv::Size size(maxWidth, std::max(1, static_cast<int>(image.rows * scale + 0.5)));
+    cv::Mat thumbnail;
+    cv::resize(image, thumbnail, size, 0, 0, cv::INTER_AREA); // Averages every source pixel, no aliasing
+    return thumbnail;
+}
+
+bool CreateOrUpdateThumbnail(const cv::Mat& image, int maxWidth, unsigned int& textureId) {
+    return UploadTexture(MakeThumbnail(image, maxWidth), textureId, true);
+}
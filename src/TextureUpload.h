@@ -0,0 +1,24 @@
+#ifndef TEXTURE_UPLOAD_H
+#define TEXTURE_UPLOAD_H
+
+#include <opencv2/opencv.hpp>
+
+// Uploads image into textureId, creating the texture if needed (textureId == 0).
+// Storage is reused when the size and format match the previous upload, data
+// streams through a pixel buffer object, and BGR/BGRA/gray images are sent
+// as-is (GL_BGR/GL_BGRA, gray via a red-channel swizzle) with no CPU conversion.
+// 8-bit, 16-bit and float images get textures of matching depth.
+bool CreateOrUpdateTexture(const cv::Mat& image, unsigned int& textureId);
+
+// Uploads a display-size copy of image instead: area-averaged down to at most
+// maxWidth pixels wide (never up), with mipmaps so zoomed-out editor views stay
+// smooth. Node previews use this, a 40 MP input then costs ~1 MB of GPU memory.
+bool CreateOrUpdateThumbnail(const cv::Mat& image, int maxWidth, unsigned int& textureId);
+
+// Area-averaged copy of image at most maxWidth wide, image itself if it fits
+cv::Mat MakeThumbnail(const cv::Mat& image, int maxWidth);
+
+// Releases a texture created by CreateOrUpdateTexture and its pixel buffer, resets textureId to 0
+void DeleteTexture(unsigned int& textureId);
+
+#endif // TEXTURE_UPLOAD_H
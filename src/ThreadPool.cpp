@@ -0,0 +1,127 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+// Index of the pool queue owned by the current thread, -1 outside the pool
+static thread_local int currentWorker = -1;
+static thread_local const ThreadPool* currentPool = nullptr;
+
+ThreadPool::ThreadPool(unsigned int threadCount) {
+    if (threadCount == 0) threadCount = 1;
+
+    for (unsigned int i = 0; i < threadCount; i++) {
+        queues.push_back(std::make_unique<WorkQueue>());
+    }
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wakeUp.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    // Workers keep their own tasks local, outside threads spread them round-robin
+    unsigned int index = (currentPool == this && currentWorker >= 0)
+        ? static_cast<unsigned int>(currentWorker)
+        : nextQueue++ % queues.size();
+
+    // Count first so the counter never drops below the number of queued tasks
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        pendingTasks++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[index]->mutex);
+        queues[index]->tasks.push_back(std::move(task));
+    }
+    wakeUp.notify_one();
+}
+
+bool ThreadPool::popTask(unsigned int preferred, std::function<void()>& task) {
+    // Own queue first (newest task, still warm in cache)
+    {
+        WorkQueue& own = *queues[preferred];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pendingTasks--;
+            return true;
+        }
+    }
+
+    // Then steal the oldest task of another worker
+    for (size_t i = 1; i < queues.size(); i++) {
+        WorkQueue& victim = *queues[(preferred + i) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pendingTasks--;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runPendingTask() {
+    unsigned int preferred = (currentPool == this && currentWorker >= 0)
+        ? static_cast<unsigned int>(currentWorker)
+        : 0;
+
+    std::function<void()> task;
+    if (!popTask(preferred, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(unsigned int index) {
+    currentWorker = static_cast<int>(index);
+    currentPool = this;
+
+    while (true) {
+        std::function<void()> task;
+        if (popTask(index, task)) {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return stopping || pendingTasks > 0; });
+        if (stopping && pendingTasks == 0) return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)>& body, unsigned int maxWorkers) {
+    if (count == 0) return;
+    if (maxWorkers == 0 || maxWorkers > size()) maxWorkers = size();
+    size_t taskCount = std::min<size_t>(maxWorkers, count);
+
+    // A few long-lived tasks pull indices, instead of one task per index
+    std::atomic<size_t> nextIndex{0};
+    std::atomic<size_t> finishedTasks{0};
+    auto drain = [&]() {
+        for (size_t i = nextIndex++; i < count; i = nextIndex++) body(i);
+    };
+    for (size_t t = 0; t < taskCount; t++) {
+        submit([&]() {
+            drain();
+            finishedTasks++;
+        });
+    }
+
+    while (finishedTasks < taskCount) {
+        if (!runPendingTask()) std::this_thread::yield();
+    }
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool. Each worker owns a deque: it pushes and pops
+// its own tasks at the back and idle workers steal from the front of the
+// others, so related tasks tend to stay on the thread that produced them.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int threadCount = std::thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Runs one queued task on the calling thread if there is any, lets
+    // threads that wait for results help instead of blocking the pool
+    bool runPendingTask();
+
+    // Calls body(i) for every i in [0, count) on up to maxWorkers pool threads
+    // (0 = all of them) and returns once all calls finished. The calling
+    // thread helps, so this is safe to use from inside pool tasks.
+    void parallelFor(size_t count, const std::function<void(size_t)>& body, unsigned int maxWorkers = 0);
+
+    unsigned int size() const { return static_cast<unsigned int>(workers.size()); }
+
+    // Process-wide pool sized to the machine
+    static ThreadPool& shared();
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    bool popTask(unsigned int preferred, std::function<void()>& task);
+    void workerLoop(unsigned int index);
+
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+    std::atomic<size_t> pendingTasks{0};
+    std::atomic<unsigned int> nextQueue{0};
+    bool stopping = false;
+};
+
+#endif // THREAD_POOL_H
@@ -1,21 +1,51 @@
 // nodes.h
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <optional>
 #include <opencv2/opencv.hpp>
 #include "imgui.h"
-#include <GLFW/glfw3.h>
 
 enum class OperationType {
     Blur,
     Brightness,
+    Contrast,
     LoadImage,
-    ProcessDisplay
+    ProcessDisplay,
+    Convolution,
+    Noise,
+    SequenceSource, // Frames of a video or image sequence, shows one of them in the editor
+    SequenceSink    // Writes every frame of its input as a video or numbered images
+};
+
+// Refers to a node in a NodeStore. The generation changes whenever the slot
+// is freed, so handles to deleted nodes stop resolving instead of silently
+// pointing at the node that reuses the slot.
+struct NodeHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    bool operator==(const NodeHandle& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const NodeHandle& other) const { return !(*this == other); }
+};
+
+// Image payload of a node. Kept out of Node (NodeStore stores it in a
+// separate array) so walks over the graph only touch the small records.
+struct NodeImages {
+    std::optional<cv::Mat> loadedCvImage; // Decoded source, or the displayed result of a ProcessDisplay node
+    std::optional<cv::Mat> reducedCvImage; // Preview-only decode of the source at 1/2-1/8 scale; loadedCvImage
+                                           // then stays unset until a full-resolution run decodes the file
+    cv::Size sourceSize; // Full-resolution size of the source, set along with either image
+    unsigned int textureId = 0; // GLuint, kept GL-free so headless builds can share this header
+    int imageWidth = 0;
+    int imageHeight = 0;
+    std::optional<cv::Mat> processedImage;
 };
 
 struct Node {
     int id;
+    NodeHandle handle; // Assigned by NodeStore::Insert
     OperationType type;
     std::string name;
     ImVec2 position;
@@ -26,18 +56,22 @@ struct Node {
     // Parameters for adjustable operations
     std::optional<float> value;
 
-    // For LoadImage node
+    // For LoadImage node; the input (SequenceSource) or output (SequenceSink) path of sequence nodes
     std::optional<std::string> imagePath;
 
-    // Shared image data and OpenGL texture info
-    std::optional<cv::Mat> loadedCvImage;
-    GLuint textureId = 0;
-    int imageWidth = 0;
-    int imageHeight = 0;
-    std::optional<cv::Mat> processedImage;
+    // For Convolution node: rows separated by ';', e.g. "0 -1 0; -1 5 -1; 0 -1 0"
+    std::optional<std::string> kernelText;
+
+    // For Noise node: generator seed, the same seed always gives the same noise
+    std::optional<uint32_t> seed;
 
     // Processing flags
     bool processingRequested = false;
+    bool fullResolutionRequested = false; // Like processingRequested, but bypasses preview proxies
+    bool saveRequested = false;           // Save once the full-resolution result arrives
+    bool pendingPreview = false;          // The run in flight evaluates on proxies
+    bool showingPreview = false;          // processedImage is a proxy-resolution result
+    int version = 0; // Bumped when parameters or loaded data change, part of the cache key
 };
 
 struct Link {
@@ -0,0 +1,253 @@
+// Headless batch runner: evaluates a saved node graph over every image in a directory.
+// Usage: batch <graph file> <input dir> <output dir> [threads] [tile size] [--cache <dir>] [--cache-size <MB>]
+//        batch <graph file> --sequences [--serial] [--frames <count>]
+#include "GraphIO.h"
+#include "ImageLoader.h"
+#include "ImageProcessor.h"
+#include "MatPool.h"
+#include "SequencePipeline.h"
+#include "utils.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static bool IsImageFile(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".tif" || ext == ".tiff" || ext == ".webp";
+}
+
+// Runs the graph template once for a single decoded input file, writes one output per ProcessDisplay node
+static bool ProcessFile(const fs::path& inputFile, const cv::Mat& input, const fs::path& outputDir,
+                        const NodeStore& graphNodes, std::vector<Link> graphLinks, int tileSize, DiskCache* diskCache,
+                        EvalStats& stats) {
+    if (input.empty()) {
+        std::cerr << "Error: Failed to load image " << inputFile << std::endl;
+        return false;
+    }
+
+    // Every LoadImage node in the template reads the current batch file
+    NodeStore nodes = graphNodes;
+    std::vector<Node*> sinks;
+    for (Node& node : nodes) {
+        if (node.type == OperationType::LoadImage) {
+            node.imagePath = inputFile.string();
+            nodes.Images(node).loadedCvImage = input;
+        }
+    }
+    for (Node& node : nodes) {
+        if (node.type == OperationType::ProcessDisplay) sinks.push_back(&node);
+    }
+
+    bool ok = true;
+    std::vector<Node*> connectedSinks;
+    std::vector<int> targetIds;
+    for (Node* sink : sinks) {
+        const Link* inputLink = FindLinkConnectedToInput(sink->inputSlotId, graphLinks);
+        Node* prevNode = inputLink ? FindNodeByOutputAttr(inputLink->fromSlot, nodes) : nullptr;
+        if (!prevNode) {
+            std::cerr << "Error: ProcessDisplay node " << sink->id << " is not connected." << std::endl;
+            ok = false;
+            continue;
+        }
+        connectedSinks.push_back(sink);
+        targetIds.push_back(prevNode->id);
+    }
+
+    // Files already keep every worker busy, nodes of one file run serially.
+    // Tiles of huge inputs still spread over the shared pool. One plan for
+    // all sinks runs shared upstream nodes once; nothing outlives the file,
+    // so chain intermediates are recycled instead of cached.
+    EvalCache processingCache;
+    EvalOptions options;
+    options.maxConcurrency = tileSize > 0 ? 0 : 1;
+    options.tileSize = tileSize;
+    options.cacheIntermediates = false;
+    options.stats = &stats;
+    options.diskCache = diskCache;
+    std::vector<cv::Mat> results;
+    if (!targetIds.empty() && !ProcessGraphTargets(targetIds, processingCache, nodes, graphLinks, results, options)) {
+        std::cerr << "Error: Processing " << inputFile << " failed." << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < connectedSinks.size(); i++) {
+        Node* sink = connectedSinks[i];
+        const cv::Mat& result = results[i];
+        if (result.empty()) {
+            std::cerr << "Error: Processing " << inputFile << " for node " << sink->id << " resulted in an empty image." << std::endl;
+            ok = false;
+            continue;
+        }
+
+        std::string filename = inputFile.stem().string();
+        if (sinks.size() > 1) filename += "_" + std::to_string(sink->id);
+        filename += inputFile.extension().string();
+        ImageProcessor::saveImage(result, (outputDir / filename).string());
+    }
+    return ok;
+}
+
+// Streams the graph's Sequence Source through it into every Sequence Output,
+// the paths come from the graph file
+static int RunSequences(const std::string& graphPath, const std::vector<std::string>& args) {
+    SequenceOptions options;
+    for (size_t i = 0; i < args.size(); i++) {
+        if (args[i] == "--serial") {
+            options.pipelined = false;
+        } else if (args[i] == "--frames" && i + 1 < args.size()) {
+            options.maxFrames = std::max(1, std::atoi(args[++i].c_str()));
+        }
+    }
+
+    NodeStore nodes;
+    std::vector<Link> links;
+    if (!LoadGraph(graphPath, nodes, links)) return 1;
+
+    std::vector<int> sinkIds;
+    for (const Node& node : nodes) {
+        if (node.type == OperationType::SequenceSink) sinkIds.push_back(node.id);
+    }
+    if (sinkIds.empty()) {
+        std::cerr << "Error: Graph " << graphPath << " has no Sequence Output node to write." << std::endl;
+        return 1;
+    }
+
+    SequenceStats stats;
+    bool ok = RunSequencePipeline(sinkIds, nodes, links, options, stats);
+    std::cout << FormatSequenceStats(stats) << std::endl;
+    return ok ? 0 : 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::string(argv[2]) == "--sequences") {
+        return RunSequences(argv[1], std::vector<std::string>(argv + 3, argv + argc));
+    }
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <graph file> <input dir> <output dir> [threads] [tile size]"
+                  << " [--cache <dir>] [--cache-size <MB>]" << std::endl;
+        std::cerr << "       " << argv[0] << " <graph file> --sequences [--serial] [--frames <count>]" << std::endl;
+        return 1;
+    }
+
+    // Options may appear anywhere after the three required arguments
+    std::vector<std::string> positional;
+    std::string cacheDir;
+    uint64_t cacheSizeMB = 4096;
+    for (int i = 4; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cache" && i + 1 < argc) {
+            cacheDir = argv[++i];
+        } else if (arg == "--cache-size" && i + 1 < argc) {
+            cacheSizeMB = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+
+    NodeStore nodes;
+    std::vector<Link> links;
+    if (!LoadGraph(argv[1], nodes, links)) return 1;
+
+    if (std::none_of(nodes.begin(), nodes.end(), [](const Node& n) { return n.type == OperationType::ProcessDisplay; })) {
+        std::cerr << "Error: Graph " << argv[1] << " has no Process & Display node to write." << std::endl;
+        return 1;
+    }
+
+    fs::path inputDir = argv[2];
+    fs::path outputDir = argv[3];
+    std::error_code ec;
+    if (!fs::is_directory(inputDir, ec)) {
+        std::cerr << "Error: " << inputDir << " is not a directory" << std::endl;
+        return 1;
+    }
+    fs::create_directories(outputDir, ec);
+
+    std::vector<fs::path> files;
+    for (const auto& entry : fs::directory_iterator(inputDir)) {
+        if (entry.is_regular_file() && IsImageFile(entry.path())) files.push_back(entry.path());
+    }
+    std::sort(files.begin(), files.end());
+    if (files.empty()) {
+        std::cerr << "No images found in " << inputDir << std::endl;
+        return 0;
+    }
+
+    unsigned int threadCount = positional.size() > 0 ? std::max(1, std::atoi(positional[0].c_str())) : std::thread::hardware_concurrency();
+    if (threadCount == 0) threadCount = 1;
+    int tileSize = positional.size() > 1 ? std::max(0, std::atoi(positional[1].c_str())) : 0;
+
+    // Unchanged files through unchanged nodes are read back instead of recomputed
+    std::unique_ptr<DiskCache> diskCache;
+    if (!cacheDir.empty()) diskCache = std::make_unique<DiskCache>(cacheDir, cacheSizeMB << 20);
+    threadCount = std::min<unsigned int>(threadCount, files.size());
+
+    // Parallelism comes from running one image per worker; OpenCV's own
+    // thread pool would only oversubscribe the cores
+    if (threadCount > 1) cv::setNumThreads(1);
+
+    // Decoding runs ahead of processing: while the workers process a file,
+    // the loader's threads already decode the next prefetchDepth files, so a
+    // worker usually finds its next input waiting. The depth bounds how many
+    // decoded images are held at once.
+    ImageLoader loader(threadCount);
+    const size_t prefetchDepth = threadCount * 2;
+    for (size_t i = 0; i < std::min(prefetchDepth, files.size()); i++) {
+        loader.Request(static_cast<int>(i), files[i].string());
+    }
+
+    // Taking a file and requesting the one prefetchDepth ahead happen under one
+    // lock, so every file's decode is requested before any worker waits on it
+    std::mutex nextFileMutex;
+    size_t nextFile = 0;
+    auto takeFile = [&]() {
+        std::lock_guard<std::mutex> lock(nextFileMutex);
+        size_t i = nextFile++;
+        if (i + prefetchDepth < files.size()) {
+            loader.Request(static_cast<int>(i + prefetchDepth), files[i + prefetchDepth].string());
+        }
+        return i;
+    };
+    std::atomic<size_t> failed{0};
+    EvalStats stats;
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (unsigned int t = 0; t < threadCount; t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = takeFile(); i < files.size(); i = takeFile()) {
+                DecodedImage decoded = loader.Wait(static_cast<int>(i));
+                if (!ProcessFile(files[i], decoded.image, outputDir, nodes, links, tileSize, diskCache.get(), stats)) failed++;
+            }
+        });
+    }
+    for (std::thread& worker : workers) worker.join();
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Processed " << files.size() << " images (" << failed << " failed) in " << seconds << " s using "
+              << threadCount << " threads: " << (files.size() / seconds) << " images/sec" << std::endl;
+    MatPool::Stats pool = MatPool::shared().stats();
+    std::cout << "Peak image memory per file: " << (stats.peakBytes >> 20) << " MB, buffers reused: " << pool.hits
+              << " of " << (pool.hits + pool.misses) << " (" << (pool.reusedBytes >> 20) << " MB)" << std::endl;
+    if (diskCache) {
+        DiskCache::Stats cacheStats = diskCache->stats();
+        std::cout << "Disk cache " << diskCache->directory() << ": " << cacheStats.hits << " hits, " << cacheStats.misses
+                  << " misses, " << cacheStats.stores << " stored (" << (cacheStats.bytesWritten >> 20) << " MB), "
+                  << cacheStats.evictions << " evicted, " << (cacheStats.totalBytes >> 20) << " MB in "
+                  << cacheStats.entries << " entries" << std::endl;
+    }
+
+    return failed == 0 ? 0 : 2;
+}
@@ -6,25 +6,380 @@
 #include "imnodes.h"
 #include "imgui_internal.h"
 #include "ImageProcessor.h"
+#include "ConvolutionEngine.h"
 #include "_Node.h"
-#include "utils.cpp"
+#include "utils.h"
+#include "GraphIO.h"
+#include "ThreadPool.h"
+#include "AsyncEvaluator.h"
+#include "ImageLoader.h"
+#include "DiskCache.h"
+#include "MemoryManager.h"
+#include "SequencePipeline.h"
+#include "TextureUpload.h"
 #include <GLFW/glfw3.h>
 #include <opencv2/opencv.hpp>
 #include <vector>
 #include <string>
 #include <optional>
 #include <map>
+#include <memory>
+#include <set>
+#include <atomic>
+#include <thread>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cctype>
+#include <cstdlib>
 
-std::vector<Node> nodes;
+NodeStore nodes; // Slot map, Node pointers stay valid until the node is deleted
 std::vector<Link> links;
 int nodeCounter = 0;
 int slotCounter = 1000;
 int linkCounter = 0;
+EvalCache evalCache; // Node results kept across "Process Graph" clicks
+int memoryBudgetMB = 2048;
+MemoryManager memoryManager(static_cast<uint64_t>(memoryBudgetMB) << 20); // Sources, displays and evalCache entries
+AsyncEvaluator asyncEvaluator(evalCache); // Runs evaluations off the UI thread
+ImageLoader imageLoader; // Decodes LoadImage files off the UI thread, keyed by node id
+const int thumbnailMaxWidth = 600; // Node textures: the widest node (300 px) on a 2x display
+int evalConcurrency = 0; // Max nodes evaluated at once, 0 = all pool threads
+bool tiledEvaluation = false; // Evaluate tile by tile to bound memory on huge inputs
+int evalTileSize = 1024;
+bool previewMode = true; // Interactive runs evaluate on downscaled proxies of the sources
+int previewSize = 1024;  // Longest side of a proxy
+bool cacheIntermediates = true; // Off trades re-evaluation speed for lower peak memory
+bool useDiskCache = false;       // Keep results on disk across sessions, shared with batch --cache
+std::unique_ptr<DiskCache> diskCache;
+std::vector<std::unique_ptr<DiskCache>> retiredDiskCaches; // Replaced caches, runs in flight may still use them
+bool showNodeProfiles = true;
+bool cullOffscreenNodes = true; // Draw only the nodes inside the editor window
+int visibleNodeCount = 0;       // Nodes drawn in full last frame
+
+// Evaluation settings chosen in the side panel, fullResolution overrides preview mode
+EvalOptions CurrentEvalOptions(bool fullResolution = false) {
+    EvalOptions options;
+    options.maxConcurrency = evalConcurrency;
+    options.tileSize = tiledEvaluation ? evalTileSize : 0;
+    options.previewMaxSize = previewMode && !fullResolution ? previewSize : 0;
+    options.cacheIntermediates = cacheIntermediates;
+    options.diskCache = useDiskCache ? diskCache.get() : nullptr;
+    return options;
+}
+
+// --- Live Mode ---
+// Edits mark the ProcessDisplay nodes downstream of them dirty; once edits
+// pause for the debounce interval, all dirty displays are evaluated in one run.
+// A burst of edits (typing, dragging) therefore costs a single evaluation.
+// Starting it supersedes older runs only for the displays it evaluates: a run
+// shared with displays the new edits did not reach keeps going and still
+// delivers to those, as their inputs did not change since it started.
+bool liveMode = false;
+float liveDebounceSeconds = 0.15f;
+static std::set<int> liveDirtyDisplays;
+static double liveLastEditTime = 0.0;
+
+// Call after changing nodeId's parameters, inputs or loaded data
+void ScheduleLiveUpdate(int nodeId) {
+    if (!liveMode) return;
+    for (int affectedId : CollectDownstreamNodes(nodeId, nodes, links)) {
+        Node* affected = FindNodeById(affectedId, nodes);
+        if (affected && affected->type == OperationType::ProcessDisplay) {
+            liveDirtyDisplays.insert(affectedId);
+        }
+    }
+    liveLastEditTime = ImGui::GetTime();
+}
+
+// --- Per-Node Editor State ---
+// Text buffers and cached strings behind each node's widgets, indexed by the
+// node's NodeStore slot, so drawing a node needs no map lookups, string
+// building or copies. The generation check resets state a deleted node left
+// in a reused slot.
+struct NodeEditorState {
+    uint32_t generation = UINT32_MAX;
+    char valueText[32] = "";
+    char pathText[256] = "";
+    char kernelText[1024] = "";
+    std::string kernelError;          // Parse error of the last kernel edit
+    std::string profileText;          // Title bar timing, formatted when a new measurement arrives
+    std::string sequenceStatus;       // Outcome of a Sequence Output's last render, per-stage timings
+    ImVec2 dimensions = ImVec2(0, 0); // Size when last drawn in full, zero until then
+    // Screen rectangles of the content origin and the pins when last drawn in
+    // full, so an off-screen stand-in puts its pins (and links) where they were
+    ImVec2 drawnOrigin = ImVec2(0, 0);
+    ImVec2 inputPinMin = ImVec2(0, 0), inputPinSize = ImVec2(0, 0);
+    ImVec2 outputPinMin = ImVec2(0, 0), outputPinSize = ImVec2(0, 0);
+};
+static std::vector<NodeEditorState> editorStates;
+
+static NodeEditorState& EditorState(const Node& node) {
+    uint32_t index = node.handle.index;
+    if (index >= editorStates.size()) editorStates.resize(index + 1);
+    NodeEditorState& state = editorStates[index];
+    if (state.generation != node.handle.generation) {
+        state = NodeEditorState();
+        state.generation = node.handle.generation;
+        snprintf(state.valueText, sizeof(state.valueText), "%f", node.value.value_or(0.0f));
+        snprintf(state.pathText, sizeof(state.pathText), "%s", node.imagePath.value_or("").c_str());
+        snprintf(state.kernelText, sizeof(state.kernelText), "%s", node.kernelText.value_or("").c_str());
+    }
+    return state;
+}
+
+// --- Zoom View ---
+// Double-clicking a node's image opens it in its own window, from fit-to-window
+// up to 16x. Node textures are thumbnails; the zoom view uploads only the part
+// of the full-resolution image inside the window (area-averaged down when
+// zoomed out), so inspecting a 40 MP image costs one window-sized texture.
+struct ZoomView {
+    int nodeId = -1;        // -1 while closed
+    bool fitPending = true; // Fit the image to the window on the first frame
+    float zoom = 1.0f;      // Screen pixels per full-resolution image pixel
+    ImVec2 center;          // Image point at the window centre, as a fraction of its size
+    unsigned int textureId = 0;
+    // What the texture holds, uploads are skipped while the view is unchanged.
+    // A handle rather than a pointer: holding the buffer keeps a new result
+    // from landing at its address and passing for the uploaded one.
+    cv::Mat uploadedSource;
+    cv::Rect uploadedRegion;
+    cv::Size uploadedSize;
+};
+static ZoomView zoomView;
+static const int zoomDecodeKey = -1; // imageLoader key of full decodes for the zoom view, node ids are >= 0
+
+void CloseZoomView() {
+    imageLoader.Cancel(zoomDecodeKey);
+    DeleteTexture(zoomView.textureId);
+    zoomView = ZoomView();
+}
+
+static bool IsSourceNode(const Node& node) {
+    return node.type == OperationType::LoadImage || node.type == OperationType::SequenceSource;
+}
+
+// Frame a source node shows: the picked one of a sequence, -1 for a still image
+static int SourceFrame(const Node& node) {
+    return node.type == OperationType::SequenceSource ? static_cast<int>(node.value.value_or(0.0f)) : -1;
+}
+
+void OpenZoomView(Node& node) {
+    CloseZoomView();
+    zoomView.nodeId = node.id;
+    // Previews leave only a reduced decode in memory, fetch the real pixels
+    const NodeImages& images = nodes.Images(node);
+    if (IsSourceNode(node) && !images.loadedCvImage.has_value() && node.imagePath.has_value()) {
+        imageLoader.Request(zoomDecodeKey, node.imagePath.value(), 0, SourceFrame(node));
+    }
+    // A result evicted by the memory budget is evaluated again, at the resolution shown
+    if (node.type == OperationType::ProcessDisplay && !images.processedImage.has_value() && images.textureId != 0) {
+        if (node.showingPreview) {
+            node.processingRequested = true;
+        } else {
+            node.fullResolutionRequested = true;
+        }
+    }
+}
+
+// Highest-resolution image of the node in memory, nullptr if none
+static const cv::Mat* ZoomSource(const Node& node, const NodeImages& images) {
+    if (node.type == OperationType::ProcessDisplay) {
+        return images.processedImage.has_value() ? &images.processedImage.value() : nullptr;
+    }
+    if (images.loadedCvImage.has_value()) return &images.loadedCvImage.value();
+    return images.reducedCvImage.has_value() ? &images.reducedCvImage.value() : nullptr;
+}
+
+// Uploads the source pixels covering the window, unless the texture holds them already
+static void UploadZoomRegion(const cv::Mat& source, const cv::Rect& region, const cv::Size& uploadSize) {
+    if (zoomView.textureId != 0 && zoomView.uploadedSource.u == source.u && zoomView.uploadedSource.data == source.data &&
+        zoomView.uploadedRegion == region && zoomView.uploadedSize == uploadSize) {
+        return;
+    }
+    cv::Mat pixels = source(region); // A view, the upload copies row by row
+    if (uploadSize != region.size()) {
+        cv::Mat scaled;
+        cv::resize(pixels, scaled, uploadSize, 0, 0, cv::INTER_AREA);
+        pixels = scaled;
+    }
+    if (!CreateOrUpdateTexture(pixels, zoomView.textureId)) return;
+    zoomView.uploadedSource = source;
+    zoomView.uploadedRegion = region;
+    zoomView.uploadedSize = uploadSize;
+}
+
+static void RenderZoomImage(const Node& node, NodeImages& images) {
+    const cv::Mat* source = ZoomSource(node, images);
+    if (!source || source->empty()) {
+        float progress = 0.0f;
+        bool pending = imageLoader.IsLoading(zoomDecodeKey) || asyncEvaluator.IsBusy(node.id, progress);
+        ImGui::TextDisabled(pending ? "Loading..." : "No image");
+        return;
+    }
+
+    // Work in source pixels; a reduced decode stands in for the full image until it arrives
+    double fullWidth = IsSourceNode(node) && images.sourceSize.width > 0 ? images.sourceSize.width : source->cols;
+    double sourceScale = source->cols / fullWidth; // Source pixels per full-resolution pixel
+
+    ImGui::Text("%.0f%%", zoomView.zoom * 100.0f);
+    if (imageLoader.IsLoading(zoomDecodeKey)) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("Reduced decode, loading full resolution...");
+    } else if (node.type == OperationType::ProcessDisplay && node.showingPreview) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("Preview, use Full Res for every pixel");
+    }
+
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 available = ImGui::GetContentRegionAvail();
+    if (available.x < 1.0f || available.y < 1.0f) return;
+    ImGui::InvisibleButton("##zoomCanvas", available);
+
+    if (zoomView.fitPending) {
+        zoomView.zoom = std::min({1.0f, available.x / static_cast<float>(fullWidth),
+                                  available.y * static_cast<float>(sourceScale) / source->rows});
+        zoomView.center = ImVec2(0.5f, 0.5f);
+        zoomView.fitPending = false;
+    }
+    const ImGuiIO& io = ImGui::GetIO();
+    if (ImGui::IsItemHovered() && io.MouseWheel != 0.0f) {
+        zoomView.zoom = ImClamp(zoomView.zoom * std::pow(1.25f, io.MouseWheel), 0.01f, 16.0f);
+    }
+    double scale = zoomView.zoom / sourceScale; // Screen pixels per source pixel
+    if (ImGui::IsItemActive()) {
+        // Drag to pan
+        zoomView.center.x = ImClamp(zoomView.center.x - static_cast<float>(io.MouseDelta.x / scale / source->cols), 0.0f, 1.0f);
+        zoomView.center.y = ImClamp(zoomView.center.y - static_cast<float>(io.MouseDelta.y / scale / source->rows), 0.0f, 1.0f);
+    }
+
+    // Source rectangle under the window, one pixel of slack on each side for partial pixels
+    double viewX = zoomView.center.x * source->cols - available.x / 2.0 / scale;
+    double viewY = zoomView.center.y * source->rows - available.y / 2.0 / scale;
+    cv::Rect region(static_cast<int>(std::floor(viewX)) - 1, static_cast<int>(std::floor(viewY)) - 1,
+                    static_cast<int>(std::ceil(available.x / scale)) + 2, static_cast<int>(std::ceil(available.y / scale)) + 2);
+    region &= cv::Rect(0, 0, source->cols, source->rows);
+    if (region.area() <= 0) return;
+
+    // Zoomed out, averaging down on the CPU keeps the upload window-sized
+    cv::Size uploadSize = region.size();
+    if (scale < 1.0) {
+        uploadSize = cv::Size(std::max(1, static_cast<int>(region.width * scale + 0.5)),
+                              std::max(1, static_cast<int>(region.height * scale + 0.5)));
+    }
+    UploadZoomRegion(*source, region, uploadSize);
+    if (zoomView.textureId == 0) return;
+
+    ImVec2 min = origin + ImVec2(static_cast<float>((region.x - viewX) * scale), static_cast<float>((region.y - viewY) * scale));
+    ImVec2 max = min + ImVec2(static_cast<float>(region.width * scale), static_cast<float>(region.height * scale));
+    ImDrawList* drawList = ImGui::GetWindowDrawList();
+    drawList->PushClipRect(origin, origin + available, true);
+    drawList->AddImage((ImTextureID)(uintptr_t)zoomView.textureId, min, max);
+    drawList->PopClipRect();
+}
+
+void ShowZoomView() {
+    if (zoomView.nodeId < 0) return;
+    Node* node = FindNodeById(zoomView.nodeId, nodes);
+    if (!node) {
+        CloseZoomView();
+        return;
+    }
+    NodeImages& images = nodes.Images(*node);
+
+    // The full decode requested on opening also serves later full-resolution runs
+    DecodedImage decoded;
+    if (imageLoader.TakeResult(zoomDecodeKey, decoded) && !decoded.image.empty() && decoded.path == node->imagePath.value_or("")) {
+        images.loadedCvImage = decoded.image;
+        images.sourceSize = decoded.fullSize;
+        memoryManager.Track(MemoryManager::Kind::Source, node->id, decoded.image);
+    }
+
+    bool open = true;
+    char title[300];
+    snprintf(title, sizeof(title), "Zoom: %s###zoomView", node->name.c_str()); // ### keeps the window id fixed
+    ImGui::SetNextWindowSize(ImVec2(800, 600), ImGuiCond_FirstUseEver);
+    if (ImGui::Begin(title, &open)) {
+        RenderZoomImage(*node, images);
+    }
+    ImGui::End();
+    if (!open) CloseZoomView();
+}
+
+// --- Memory Budget ---
+// memoryManager accounts every image kept between evaluations and, once per
+// frame, evicts the least recently used ones beyond the budget. Evaluations
+// decode missing sources themselves, cache misses are recomputed, and Save
+// Image or the zoom view evaluate an evicted display result again; thumbnails
+// live on the GPU and stay, so nodes look the same throughout.
+
+// Marks the sources an evaluation of targetId reads as just used. Nodes have
+// one input, so the upstream of a node is a chain ending at its source.
+void TouchUpstreamSources(int targetId) {
+    Node* node = FindNodeById(targetId, nodes);
+    for (int steps = 0; node && steps <= static_cast<int>(nodes.size()); steps++) { // Bounded in case of a cycle
+        if (IsSourceNode(*node)) {
+            memoryManager.Touch(MemoryManager::Kind::Source, node->id);
+            memoryManager.Touch(MemoryManager::Kind::ReducedSource, node->id);
+            return;
+        }
+        const Link* inputLink = FindLinkConnectedToInput(node->inputSlotId, links);
+        node = inputLink ? FindNodeByOutputAttr(inputLink->fromSlot, nodes) : nullptr;
+    }
+}
+
+// True if a preview run of targetId evaluates on a downscaled proxy, i.e. its
+// source is larger than previewMaxSize. A source not decoded yet counts as
+// larger, its result must not pass for full resolution.
+bool PreviewDownscales(int targetId, int previewMaxSize) {
+    if (previewMaxSize <= 0) return false;
+    Node* node = FindNodeById(targetId, nodes);
+    for (int steps = 0; node && steps <= static_cast<int>(nodes.size()); steps++) { // Bounded in case of a cycle
+        if (IsSourceNode(*node)) {
+            cv::Size size = nodes.Images(*node).sourceSize;
+            return size.width <= 0 || std::max(size.width, size.height) > previewMaxSize;
+        }
+        const Link* inputLink = FindLinkConnectedToInput(node->inputSlotId, links);
+        node = inputLink ? FindNodeByOutputAttr(inputLink->fromSlot, nodes) : nullptr;
+    }
+    return false;
+}
+
+// Drops an image picked by the memory manager, keeps whatever the zoom view shows
+static bool EvictForMemoryBudget(MemoryManager::Kind kind, int nodeId) {
+    if (kind == MemoryManager::Kind::CachedResult || kind == MemoryManager::Kind::CachedPreview) {
+        evalCache.Erase(nodeId, kind == MemoryManager::Kind::CachedPreview ? EvalCache::Resolution::Preview : EvalCache::Resolution::Full);
+        return true;
+    }
+    if (nodeId == zoomView.nodeId) return false;
+    Node* node = FindNodeById(nodeId, nodes);
+    if (!node) return true;
+    NodeImages& images = nodes.Images(*node);
+    switch (kind) {
+        case MemoryManager::Kind::Source:
+            images.loadedCvImage.reset();
+            break;
+        case MemoryManager::Kind::ReducedSource:
+            images.reducedCvImage.reset();
+            break;
+        case MemoryManager::Kind::Display:
+            images.loadedCvImage.reset();
+            images.processedImage.reset();
+            break;
+        default:
+            break;
+    }
+    return true;
+}
+
+void EnforceMemoryBudget() {
+    memoryManager.Enforce(EvictForMemoryBudget);
+}
 
 void displayImage(Node& node) {
+    const NodeImages& images = nodes.Images(node);
     // Calculate display size, maintaining aspect ratio within node width
-    float aspectRatio = (float)node.imageHeight / (float)node.imageWidth;
+    float aspectRatio = (float)images.imageHeight / (float)images.imageWidth;
     float displayWidth = node.width - ImGui::GetStyle().FramePadding.x * 2; // Use node width minus padding
     float displayHeight = displayWidth * aspectRatio;
 
@@ -32,7 +387,10 @@ void displayImage(Node& node) {
     float spaceX = (node.width - displayWidth) / 2.0f;
     ImGui::SetCursorPosX(ImGui::GetCursorPosX() + spaceX);
 
-    ImGui::Image((ImTextureID)(uintptr_t)node.textureId, ImVec2(displayWidth, displayHeight));
+    ImGui::Image((ImTextureID)(uintptr_t)images.textureId, ImVec2(displayWidth, displayHeight));
+    if (ImGui::IsItemHovered() && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+        OpenZoomView(node);
+    }
 }
 
 void AddNode(OperationType type, const std::string& name, ImVec2 pos) {
@@ -46,16 +404,27 @@ void AddNode(OperationType type, const std::string& name, ImVec2 pos) {
     // Assign slots based on type
     if (type == OperationType::LoadImage) {
         node.outputSlotId = slotCounter++; // Load has output only
-    } else if (type == OperationType::ProcessDisplay) {
+    } else if (type == OperationType::SequenceSource) {
+        node.outputSlotId = slotCounter++;
+        node.value = 0.0f; // Frame shown in the editor
+    } else if (type == OperationType::ProcessDisplay || type == OperationType::SequenceSink) {
         node.inputSlotId = slotCounter++; // ProcessDisplay has input only
         node.width = 200; // Maybe make it wider by default
-    } else { // Processing nodes (Blur, Brightness)
+    } else { // Processing nodes (Blur, Brightness, Contrast, Convolution, Noise)
         node.inputSlotId = slotCounter++;
         node.outputSlotId = slotCounter++;
-        node.value = 0.0f; // Default value for processing nodes
+        bool scales = type == OperationType::Contrast || type == OperationType::Convolution;
+        node.value = scales ? 1.0f : 0.0f; // Default value for processing nodes
+        if (type == OperationType::Convolution) node.kernelText = "0 -1 0; -1 5 -1; 0 -1 0"; // Sharpen
+        if (type == OperationType::Noise) {
+            // Amount, 5% of the full range. The node's value is the only amount
+            // setting: NoiseSettings (Settings.cpp) is not part of the build.
+            node.value = 0.05f;
+            node.seed = 0;
+        }
     }
 
-    nodes.push_back(node);
+    nodes.Insert(std::move(node));
 }
 
 void handleNodeConnection(int startAttr, int endAttr) {
@@ -71,7 +440,9 @@ void handleNodeConnection(int startAttr, int endAttr) {
         if (node.inputSlotId == endAttr) {
             targetNodeId = node.id;
             // Check if it's a type that should only have one input
-            if (node.type == OperationType::Brightness || node.type == OperationType::Blur) {
+            if (node.type == OperationType::Brightness || node.type == OperationType::Contrast || node.type == OperationType::Blur ||
+                node.type == OperationType::Convolution || node.type == OperationType::Noise ||
+                node.type == OperationType::SequenceSink) {
                  targetIsInput = true;
                  break; // Found the node and it's a relevant type
             }
@@ -98,152 +469,177 @@ void handleNodeConnection(int startAttr, int endAttr) {
         // You might want to add further checks to ensure startAttr is an output and endAttr is an input.
 
         links.push_back({linkCounter++, startAttr, endAttr});
+
+        // The consumer now reads a different input
+        for (const Node& node : nodes) {
+            if (node.inputSlotId == endAttr) {
+                evalCache.Invalidate(node.id, nodes, links);
+                ScheduleLiveUpdate(node.id);
+                break;
+            }
+        }
     } else {
         std::cout << "Node input already connected. Cannot add new link." << std::endl;
     }
 }
 
-// --- Helper function to create/update OpenGL texture from cv::Mat ---
-//     Place this function somewhere accessible, e.g., before RenderLoadImageNode
-bool CreateOrUpdateTexture(const cv::Mat& image, GLuint& textureId) {
-    if (image.empty()) {
-        return false;
-    }
-
-    // If texture already exists, delete it first
-    if (textureId != 0) {
-        glDeleteTextures(1, &textureId);
-        textureId = 0;
-    }
+// --- Pins ---
+// Dragging a link off an input pin detaches it, RenderNodes then deletes it
+// (IsLinkDestroyed). Output pins keep the default, a drag there starts a new link.
+// Ending a pin records where it was drawn for RenderCulledNode.
+static void BeginInputPin(int slotId) {
+    ImNodes::PushAttributeFlag(ImNodesAttributeFlags_EnableLinkDetachWithDragClick);
+    ImNodes::BeginInputAttribute(slotId);
+}
 
-    // Create new texture
-    glGenTextures(1, &textureId);
-    glBindTexture(GL_TEXTURE_2D, textureId);
+static void EndInputPin(NodeEditorState& state) {
+    ImNodes::EndInputAttribute();
+    ImNodes::PopAttributeFlag();
+    state.inputPinMin = ImGui::GetItemRectMin();
+    state.inputPinSize = ImGui::GetItemRectSize();
+}
 
-    // Set texture parameters (you might want different settings)
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE); // Avoid border artifacts
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+static void EndOutputPin(NodeEditorState& state) {
+    ImNodes::EndOutputAttribute();
+    state.outputPinMin = ImGui::GetItemRectMin();
+    state.outputPinSize = ImGui::GetItemRectSize();
+}
 
-    // Convert cv::Mat BGR to RGBA for OpenGL
-    cv::Mat imageRGBA;
-    if (image.channels() == 3) {
-        cv::cvtColor(image, imageRGBA, cv::COLOR_BGR2RGBA);
-    } else if (image.channels() == 1) {
-        cv::cvtColor(image, imageRGBA, cv::COLOR_GRAY2RGBA);
-    } else if (image.channels() == 4) {
-        // Assuming it's BGRA, convert to RGBA
-         cv::cvtColor(image, imageRGBA, cv::COLOR_BGRA2RGBA);
+// --- Loads node.imagePath into the node and refreshes its preview texture ---
+// Starts decoding the node's file in the background, UpdateLoadImageNode shows it once done.
+// In preview mode only a reduced decode is requested; a full-resolution run
+// (Full Res, Save Image, batch) decodes the whole file when it needs it.
+void LoadImageIntoNode(Node& node) {
+    NodeImages& images = nodes.Images(node);
+    // Whatever was computed from the previous image is stale now
+    node.version++;
+    evalCache.Invalidate(node.id, nodes, links);
+    images.loadedCvImage.reset();
+    images.reducedCvImage.reset();
+    images.sourceSize = cv::Size();
+    memoryManager.Release(MemoryManager::Kind::Source, node.id);
+    memoryManager.Release(MemoryManager::Kind::ReducedSource, node.id);
+
+    if (node.imagePath.has_value() && !node.imagePath.value().empty()) {
+        imageLoader.Request(node.id, node.imagePath.value(), previewMode ? previewSize : 0, SourceFrame(node));
+    } else {
+        // Path is empty, clear resources
+        imageLoader.Cancel(node.id);
+        DeleteTexture(images.textureId);
+        images.imageWidth = 0;
+        images.imageHeight = 0;
+        ScheduleLiveUpdate(node.id);
     }
-     else {
-        // Handle other cases or return false if unsupported format
-        glBindTexture(GL_TEXTURE_2D, 0); // Unbind
-        glDeleteTextures(1, &textureId); // Clean up allocated texture ID
-        textureId = 0;
-        return false;
+}
+
+// Picks up a finished decode and uploads its texture. RenderNodes calls it for
+// LoadImage and SequenceSource nodes with a result waiting, on screen or not.
+void UpdateLoadImageNode(Node& node) {
+    // A run decoded the file in its snapshot (a full-resolution run, or the
+    // decode was evicted by the memory budget); keep what it decoded so the
+    // next run that misses the cache does not read the file again
+    AsyncEvaluator::DecodedSource fromRun;
+    if (asyncEvaluator.TakeDecodedSource(node.id, fromRun) && fromRun.version == node.version) {
+        NodeImages& images = nodes.Images(node);
+        if (!fromRun.full.empty() && !images.loadedCvImage.has_value()) {
+            images.loadedCvImage = fromRun.full;
+            images.sourceSize = fromRun.sourceSize;
+            memoryManager.Track(MemoryManager::Kind::Source, node.id, fromRun.full);
+        }
+        if (!fromRun.reduced.empty() && !images.reducedCvImage.has_value()) {
+            images.reducedCvImage = fromRun.reduced;
+            images.sourceSize = fromRun.sourceSize;
+            memoryManager.Track(MemoryManager::Kind::ReducedSource, node.id, fromRun.reduced);
+        }
     }
 
+    DecodedImage decoded;
+    if (!imageLoader.TakeResult(node.id, decoded)) return;
+
+    NodeImages& images = nodes.Images(node);
+    // Runs started while the file was decoding loaded it themselves
+    node.version++;
+    evalCache.Invalidate(node.id, nodes, links);
+    ScheduleLiveUpdate(node.id);
+
+    if (decoded.image.empty()) {
+        std::cerr << "Error: Failed to load image " << decoded.path << std::endl;
+        DeleteTexture(images.textureId);
+        images.imageWidth = 0;
+        images.imageHeight = 0;
+        return;
+    }
 
-    // Upload image data to texture
-    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); // Ensure correct alignment
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, imageRGBA.cols, imageRGBA.rows, 0,
-                   GL_RGBA, GL_UNSIGNED_BYTE, imageRGBA.data);
+    if (decoded.reduction > 1) {
+        images.reducedCvImage = decoded.image;
+        memoryManager.Track(MemoryManager::Kind::ReducedSource, node.id, decoded.image);
+    } else {
+        images.loadedCvImage = decoded.image;
+        memoryManager.Track(MemoryManager::Kind::Source, node.id, decoded.image);
+    }
+    images.sourceSize = decoded.fullSize;
 
-    glBindTexture(GL_TEXTURE_2D, 0); // Unbind texture
+    if (CreateOrUpdateThumbnail(decoded.image, thumbnailMaxWidth, images.textureId)) {
+        images.imageWidth = decoded.image.cols;
+        images.imageHeight = decoded.image.rows;
+    } else {
+        // Texture creation failed; the decoded image still feeds evaluations
+        images.textureId = 0;
+        images.imageWidth = 0;
+        images.imageHeight = 0;
+        std::cerr << "Error: Failed to create texture for " << decoded.path << std::endl;
+    }
+}
 
-    return true;
+// Requests decodes matching the current preview settings for sources that
+// only hold a reduced one, e.g. after raising the preview size
+void RefreshSourceDecodes() {
+    for (Node& node : nodes) {
+        if (IsSourceNode(node) && node.imagePath.has_value() && !node.imagePath.value().empty() &&
+            !nodes.Images(node).loadedCvImage.has_value()) {
+            LoadImageIntoNode(node);
+        }
+    }
 }
 
 // --- Helper Function for Load Image Nodes ---
-void RenderLoadImageNode(Node& node) {
-    // Note: pathBuffers should ideally be managed differently if nodes can be deleted,
-    // but keeping static for simplicity based on previous code.
-    static std::map<int, std::string> pathBuffers;
-
+void RenderLoadImageNode(Node& node, NodeEditorState& state) {
     // --- Input Path Text Field ---
-    char buf[64];
-    snprintf(buf, sizeof(buf), "##path%d", node.id);
-
-    std::string currentPath = node.imagePath.value_or("");
-    if (pathBuffers.find(node.id) == pathBuffers.end()) {
-        pathBuffers[node.id] = currentPath;
-    }
-
-    char inputText[256];
-    strncpy(inputText, pathBuffers[node.id].c_str(), sizeof(inputText));
-    inputText[sizeof(inputText) - 1] = '\0';
-
     bool pathChanged = false;
-    if (ImGui::InputText(buf, inputText, IM_ARRAYSIZE(inputText), ImGuiInputTextFlags_EnterReturnsTrue)) {
-        node.imagePath = inputText;
-        pathBuffers[node.id] = inputText;
-        currentPath = inputText; // Update currentPath after change
+    if (ImGui::InputText("##path", state.pathText, IM_ARRAYSIZE(state.pathText), ImGuiInputTextFlags_EnterReturnsTrue)) {
+        node.imagePath = std::string(state.pathText);
         pathChanged = true;
     }
 
+    // A sequence previews one of its frames, the graph is edited against that
+    if (node.type == OperationType::SequenceSource) {
+        int frame = SourceFrame(node);
+        if (ImGui::InputInt("Frame", &frame)) {
+            node.value = static_cast<float>(std::max(0, frame));
+            pathChanged = true;
+        }
+    }
+
     // --- Output Attribute (LoadImage only has output) ---
     ImNodes::BeginOutputAttribute(node.outputSlotId);
     // Align text to the right for output node
     ImGui::Indent(node.width - ImGui::CalcTextSize("Output").x - ImGui::GetStyle().FramePadding.x * 2); // Adjust padding
     ImGui::Text("Output");
     ImGui::Unindent(); // Match Indent
-    ImNodes::EndOutputAttribute();
+    EndOutputPin(state);
 
 
     // --- Load Image and Update Texture if Path Changed ---
     // Check if path changed OR if it's different from the last successfully loaded path
     if (pathChanged) {
-        // --- This is the block that now runs only when pathChanged is true ---
-        if (node.imagePath.has_value() && !node.imagePath.value().empty()) {
-            // Attempt to load the image
-            node.loadedCvImage = ImageProcessor::loadImage(node.imagePath.value()); // loadImage returns cv::Mat [cite: 3]
-
-            if (node.loadedCvImage.has_value() && !node.loadedCvImage.value().empty()) {
-                 // Successfully loaded, update texture
-                if (CreateOrUpdateTexture(node.loadedCvImage.value(), node.textureId)) {
-                    node.imageWidth = node.loadedCvImage.value().cols;
-                    node.imageHeight = node.loadedCvImage.value().rows;
-                    // node.lastLoadedPath = node.imagePath.value(); // Optional: Keep track if needed elsewhere
-                } else {
-                    // Texture creation failed
-                    node.textureId = 0; // Ensure texture ID is reset
-                    // node.lastLoadedPath = ""; // Reset if using lastLoadedPath tracking
-                    node.loadedCvImage.reset(); // Clear the cv::Mat too
-                    node.imageWidth = 0;
-                    node.imageHeight = 0;
-                    std::cerr << "Error: Failed to create texture for " << node.imagePath.value() << std::endl;
-                }
-
-            } else {
-                // Loading failed (ImageProcessor::loadImage returned empty Mat) [cite: 3]
-                std::cerr << "Error: Failed to load image " << node.imagePath.value() << std::endl;
-                // Delete existing texture if any
-                if (node.textureId != 0) {
-                    glDeleteTextures(1, &node.textureId);
-                    node.textureId = 0;
-                }
-                node.imageWidth = 0;
-                node.imageHeight = 0;
-                // node.lastLoadedPath = ""; // Reset if using lastLoadedPath tracking
-                node.loadedCvImage.reset(); // Clear the cv::Mat
-            }
-        } else {
-            // Path is empty, clear resources
-            if (node.textureId != 0) {
-                glDeleteTextures(1, &node.textureId);
-                node.textureId = 0;
-            }
-            node.imageWidth = 0;
-            node.imageHeight = 0;
-            // node.lastLoadedPath = ""; // Reset if using lastLoadedPath tracking
-            node.loadedCvImage.reset();
-        }
-        // --- End of block that runs only when pathChanged is true ---
+        LoadImageIntoNode(node);
     }
 
     // --- Display Image using ImGui::Image ---
-    if (node.textureId != 0 && node.imageWidth > 0 && node.imageHeight > 0) {
+    const NodeImages& images = nodes.Images(node);
+    if (imageLoader.IsLoading(node.id)) {
+        ImGui::TextDisabled("Loading...");
+    } else if (images.textureId != 0 && images.imageWidth > 0 && images.imageHeight > 0) {
         displayImage(node);
     } else {
         // Optionally display a placeholder if no image is loaded/valid
@@ -251,127 +647,208 @@ void RenderLoadImageNode(Node& node) {
     }
 }
 
-// --- Helper Function for Processing Nodes (Brightness, Blur) ---
-void RenderProcessingNode(Node& node) {
+// Kernel text field of a Convolution node, the value field above scales it
+void RenderKernelInput(Node& node, NodeEditorState& state, ImGuiInputTextFlags flags) {
+    if (ImGui::InputText("##kernel", state.kernelText, IM_ARRAYSIZE(state.kernelText), flags)) {
+        cv::Mat kernel;
+        if (!ParseConvolutionKernel(state.kernelText, kernel, state.kernelError)) {
+            // kernelError now holds the message
+        } else {
+            state.kernelError.clear();
+            if (state.kernelText != node.kernelText.value_or("")) {
+                node.kernelText = std::string(state.kernelText);
+                node.version++;
+                evalCache.Invalidate(node.id, nodes, links);
+                ScheduleLiveUpdate(node.id);
+            }
+        }
+    }
+
+    if (!state.kernelError.empty()) {
+        ImGui::TextColored(ImVec4(1.0f, 0.4f, 0.4f, 1.0f), "%s", state.kernelError.c_str());
+    } else {
+        ImGui::TextDisabled("Rows split by ';'");
+    }
+}
+
+// Seed field of a Noise node, a new seed gives a new but equally reproducible pattern
+void RenderSeedInput(Node& node) {
+    int seed = static_cast<int>(node.seed.value_or(0));
+    if (ImGui::InputInt("Seed", &seed) && seed >= 0 && static_cast<uint32_t>(seed) != node.seed.value_or(0)) {
+        node.seed = static_cast<uint32_t>(seed);
+        node.version++;
+        evalCache.Invalidate(node.id, nodes, links);
+        ScheduleLiveUpdate(node.id);
+    }
+}
+
+// --- Helper Function for Processing Nodes (Brightness, Contrast, Blur, Convolution, Noise) ---
+void RenderProcessingNode(Node& node, NodeEditorState& state) {
     // Specific rendering logic for nodes like Brightness, Blur
 
     // Input Attribute
-    ImNodes::BeginInputAttribute(node.inputSlotId);
+    BeginInputPin(node.inputSlotId);
     ImGui::Text("Input");
-    ImNodes::EndInputAttribute();
+    EndInputPin(state);
 
     // Value Input
-    // Note: 'inputBuffers' needs to be accessible here.
-    static std::map<int, std::string> inputBuffers;
-    char buf[32];
-    snprintf(buf, sizeof(buf), "##val%d", node.id);
-
-    // Use .value_or(0.0f) to provide a default if optional is empty
-    if (inputBuffers.find(node.id) == inputBuffers.end())
-        inputBuffers[node.id] = std::to_string(node.value.value_or(0.0f));
-
-    char input[32];
-    strncpy(input, inputBuffers[node.id].c_str(), sizeof(input));
-    input[sizeof(input) - 1] = '\0';
-
-    if (ImGui::InputText(buf, input, IM_ARRAYSIZE(input), ImGuiInputTextFlags_EnterReturnsTrue)) {
-        try {
-            node.value = std::stof(input); // Assign directly to optional float
-            inputBuffers[node.id] = input;
-        } catch (...) {
-            // Optional: Add visual feedback for parse error
+    // Live mode applies every keystroke, the debounce keeps that cheap
+    ImGuiInputTextFlags flags = liveMode ? 0 : ImGuiInputTextFlags_EnterReturnsTrue;
+    if (ImGui::InputText("##val", state.valueText, IM_ARRAYSIZE(state.valueText), flags)) {
+        char* end = nullptr;
+        float value = std::strtof(state.valueText, &end);
+        if (end != state.valueText && value != node.value.value_or(0.0f)) {
+            node.value = value; // Assign directly to optional float
+            node.version++;
+            evalCache.Invalidate(node.id, nodes, links);
+            ScheduleLiveUpdate(node.id);
         }
     }
 
+    if (node.type == OperationType::Convolution) RenderKernelInput(node, state, flags);
+    if (node.type == OperationType::Noise) RenderSeedInput(node);
+
     // Output Attribute
     ImNodes::BeginOutputAttribute(node.outputSlotId);
     // Align text to the right for output node
     ImGui::Indent(node.width - ImGui::CalcTextSize("Output").x - ImGui::GetStyle().FramePadding.x);
     ImGui::Text("Output");
-    ImNodes::EndOutputAttribute();
+    EndOutputPin(state);
 }
 
 
-// Remember to include the helper for texture creation from previous steps
-// bool CreateOrUpdateTexture(const cv::Mat& image, GLuint& textureId);
+// --- Shows a finished evaluation on a ProcessDisplay node, clears it if the result is empty ---
+void UpdateDisplayResult(Node& node, const cv::Mat& result) {
+    NodeImages& images = nodes.Images(node);
+    if (!result.empty()) {
+        std::cout << "--- Processing Finished. Updating Texture and Processed Image for Node " << node.id << " ---" << std::endl;
+        images.loadedCvImage = result; // Store the final result
+        images.processedImage = result; // Shared with the display image, both are read-only
+        memoryManager.Track(MemoryManager::Kind::Display, node.id, result);
+        node.showingPreview = node.pendingPreview;
+
+        // Update this node's texture
+        if (CreateOrUpdateThumbnail(images.loadedCvImage.value(), thumbnailMaxWidth, images.textureId)) {
+            images.imageWidth = images.loadedCvImage.value().cols;
+            images.imageHeight = images.loadedCvImage.value().rows;
+        } else {
+            // Texture creation failed
+            images.textureId = 0;
+            images.imageWidth = 0;
+            images.imageHeight = 0;
+            images.loadedCvImage.reset();
+            images.processedImage.reset();
+            memoryManager.Release(MemoryManager::Kind::Display, node.id);
+            std::cerr << "Error: Failed to create texture for ProcessDisplay node " << node.id << std::endl;
+        }
+    } else {
+        std::cerr << "Error: Processing graph for node " << node.id << " resulted in an empty image." << std::endl;
+        // Clear previous result if processing failed
+        DeleteTexture(images.textureId);
+        images.imageWidth = 0;
+        images.imageHeight = 0;
+        images.loadedCvImage.reset();
+        images.processedImage.reset();
+        memoryManager.Release(MemoryManager::Kind::Display, node.id);
+    }
+}
 
-void RenderProcessDisplayNode(Node& node) {
-    // Input Attribute
-    ImNodes::BeginInputAttribute(node.inputSlotId);
-    ImGui::Text("Input");
-    ImNodes::EndInputAttribute();
+// --- Writes the processed image of a ProcessDisplay node to output_<id>.png ---
+void SaveDisplayImage(const Node& node) {
+    const NodeImages& images = nodes.Images(node);
+    std::string filename = "output_" + std::to_string(node.id) + ".png";
+    memoryManager.Touch(MemoryManager::Kind::Display, node.id);
+    ImageProcessor::saveImage(images.processedImage.value(), filename);
+    std::cout << "Saved processed image to " << filename << std::endl;
+}
 
-    ImGui::Spacing();
+// Starts requested evaluations and picks up finished ones. RenderNodes calls it
+// for display nodes with a request or a result waiting, on screen or not.
+void UpdateProcessDisplayNode(Node& node) {
+    NodeImages& images = nodes.Images(node);
 
-    // Process Button
-    if (ImGui::Button("Process Graph")) {
-        node.processingRequested = true; // Set flag to process
-    }
-
-    // --- Trigger Processing and Immediately Update processedImage ---
-    if (node.processingRequested) {
-        node.processingRequested = false; // Reset flag
+    // --- Trigger Processing in the Background ---
+    if (node.processingRequested || node.fullResolutionRequested) {
+        EvalOptions options = CurrentEvalOptions(node.fullResolutionRequested);
+        node.processingRequested = false; // Reset flags
+        node.fullResolutionRequested = false;
 
         const Link* inputLink = FindLinkConnectedToInput(node.inputSlotId, links);
         if (inputLink) {
             Node* prevNode = FindNodeByOutputAttr(inputLink->fromSlot, nodes);
             if (prevNode) {
                 std::cout << "--- Processing Triggered for Node " << node.id << " ---" << std::endl;
-                std::map<int, cv::Mat> processingCache;
-                cv::Mat result = ProcessGraphRecursive(prevNode->id, processingCache, nodes, links);
-
-                if (!result.empty()) {
-                    std::cout << "--- Processing Finished. Updating Texture and Processed Image for Node " << node.id << " ---" << std::endl;
-                    node.loadedCvImage = result; // Store the final result
-                    node.processedImage = result.clone(); // Store the processed image for saving
-
-                    // Update this node's texture
-                    if (CreateOrUpdateTexture(node.loadedCvImage.value(), node.textureId)) {
-                        node.imageWidth = node.loadedCvImage.value().cols;
-                        node.imageHeight = node.loadedCvImage.value().rows;
-                    } else {
-                        // Texture creation failed
-                        node.textureId = 0;
-                        node.imageWidth = 0;
-                        node.imageHeight = 0;
-                        node.loadedCvImage.reset();
-                        node.processedImage.reset();
-                        std::cerr << "Error: Failed to create texture for ProcessDisplay node " << node.id << std::endl;
-                    }
-                } else {
-                    std::cerr << "Error: Processing graph for node " << node.id << " resulted in an empty image." << std::endl;
-                    // Clear previous result if processing failed
-                    if (node.textureId != 0) glDeleteTextures(1, &node.textureId);
-                    node.textureId = 0;
-                    node.imageWidth = 0;
-                    node.imageHeight = 0;
-                    node.loadedCvImage.reset();
-                    node.processedImage.reset();
-                }
+                node.pendingPreview = PreviewDownscales(prevNode->id, options.previewMaxSize);
+                TouchUpstreamSources(prevNode->id);
+                asyncEvaluator.Start({node.id}, {prevNode->id}, nodes, links, options);
             } else {
                 std::cerr << "Error: Could not find node connected to input of ProcessDisplay node " << node.id << std::endl;
+                asyncEvaluator.Cancel(node.id);
                 // Clear results if no input node
-                if (node.textureId != 0) glDeleteTextures(1, &node.textureId);
-                node.textureId = 0;
-                node.imageWidth = 0;
-                node.imageHeight = 0;
-                node.loadedCvImage.reset();
-                node.processedImage.reset();
+                DeleteTexture(images.textureId);
+                images.imageWidth = 0;
+                images.imageHeight = 0;
+                images.loadedCvImage.reset();
+                images.processedImage.reset();
+                memoryManager.Release(MemoryManager::Kind::Display, node.id);
             }
         } else {
             std::cerr << "Error: ProcessDisplay node " << node.id << " is not connected." << std::endl;
+            asyncEvaluator.Cancel(node.id);
             // Clear results if not connected
-            if (node.textureId != 0) glDeleteTextures(1, &node.textureId);
-            node.textureId = 0;
-            node.imageWidth = 0;
-            node.imageHeight = 0;
-            node.loadedCvImage.reset();
-            node.processedImage.reset();
+            DeleteTexture(images.textureId);
+            images.imageWidth = 0;
+            images.imageHeight = 0;
+            images.loadedCvImage.reset();
+            images.processedImage.reset();
+            memoryManager.Release(MemoryManager::Kind::Display, node.id);
+        }
+    }
+
+    // --- Pick Up a Finished Result (texture upload happens here, on the render thread) ---
+    cv::Mat finished;
+    if (asyncEvaluator.TakeResult(node.id, finished)) {
+        UpdateDisplayResult(node, finished);
+        if (node.saveRequested && !node.showingPreview && images.processedImage.has_value()) {
+            SaveDisplayImage(node);
+        }
+        node.saveRequested = false;
+    }
+}
+
+void RenderProcessDisplayNode(Node& node, NodeEditorState& state) {
+    NodeImages& images = nodes.Images(node);
+    // Input Attribute
+    BeginInputPin(node.inputSlotId);
+    ImGui::Text("Input");
+    EndInputPin(state);
+
+    ImGui::Spacing();
+
+    // Process Button
+    if (ImGui::Button("Process Graph")) {
+        node.processingRequested = true; // Set flag to process
+    }
+    if (previewMode) {
+        ImGui::SameLine();
+        if (ImGui::Button("Full Res")) {
+            node.fullResolutionRequested = true;
+        }
+    }
+
+    // --- Busy State ---
+    float progress = 0.0f;
+    if (asyncEvaluator.IsBusy(node.id, progress)) {
+        ImGui::ProgressBar(progress, ImVec2(node.width, 0));
+        if (ImGui::Button("Cancel")) {
+            asyncEvaluator.Cancel(node.id);
+            node.saveRequested = false;
         }
     }
 
     // --- Display Result Image ---
-    if (node.textureId != 0 && node.imageWidth > 0 && node.imageHeight > 0) {
+    if (images.textureId != 0 && images.imageWidth > 0 && images.imageHeight > 0) {
+        if (node.showingPreview) ImGui::TextDisabled("Preview %dx%d", images.imageWidth, images.imageHeight);
         displayImage(node);
     } else {
         // Placeholder text
@@ -379,19 +856,211 @@ void RenderProcessDisplayNode(Node& node) {
     }
 
     // --- Save Button Rendering ---
-    if (node.processedImage.has_value() && !node.processedImage.value().empty()) {
-        if (ImGui::Button(("Save Image##" + std::to_string(node.id)).c_str())) {
-            std::string filename = "output_" + std::to_string(node.id) + ".png";
-            ImageProcessor::saveImage(node.processedImage.value(), filename);
-            std::cout << "Saved processed image to " << filename << std::endl;
+    bool evicted = !images.processedImage.has_value() && images.textureId != 0; // Dropped by the memory budget
+    if ((images.processedImage.has_value() && !images.processedImage.value().empty()) || evicted) {
+        if (ImGui::Button("Save Image")) {
+            if (node.showingPreview || evicted) {
+                // Never write a proxy to disk, evaluate at full resolution and save when it lands
+                node.fullResolutionRequested = true;
+                node.saveRequested = true;
+            } else {
+                SaveDisplayImage(node);
+            }
         }
     } else {
         ImGui::Text("No image to save");
     }
 }
 
+// --- Sequence Output Nodes ---
+// Render Sequence streams every frame of the source through the graph on a
+// thread of its own, against a snapshot of the graph like AsyncEvaluator, so
+// the editor stays responsive and edits made meanwhile don't leak into the
+// output. The result is the written file(s); nothing comes back to the editor
+// but the stage timings.
+struct SequenceRender {
+    NodeStore nodes;
+    std::vector<Link> links;
+    EvalProgress progress;
+    SequenceStats stats;
+    bool ok = false;
+    std::atomic<bool> finished{false};
+    std::thread thread;
+};
+static std::map<int, std::unique_ptr<SequenceRender>> sequenceRenders; // By SequenceSink id
+
+void StartSequenceRender(Node& sink) {
+    if (sequenceRenders.count(sink.id)) return;
+    auto render = std::make_unique<SequenceRender>();
+    render->nodes = nodes;
+    render->links = links;
+    SequenceRender* run = render.get();
+    int sinkId = sink.id;
+    run->thread = std::thread([run, sinkId]() {
+        SequenceOptions options;
+        options.progress = &run->progress;
+        run->ok = RunSequencePipeline({sinkId}, run->nodes, run->links, options, run->stats);
+        run->finished = true;
+    });
+    EditorState(sink).sequenceStatus.clear();
+    sequenceRenders[sink.id] = std::move(render);
+}
+
+// Joins a finished render and reports it on its node, called every frame
+void UpdateSequenceRender(Node& sink) {
+    auto it = sequenceRenders.find(sink.id);
+    if (it == sequenceRenders.end() || !it->second->finished) return;
+    SequenceRender& run = *it->second;
+    run.thread.join();
+    std::string status = run.progress.cancelled ? "Cancelled after " : run.ok ? "Done, " : "Failed after ";
+    status += FormatSequenceStats(run.stats);
+    std::cout << "Sequence output " << sink.id << ": " << status << std::endl;
+    EditorState(sink).sequenceStatus = status;
+    sequenceRenders.erase(it);
+}
+
+// Stops a render and waits for its stages to wind down, frames written so far stay
+void CancelSequenceRender(int sinkId) {
+    auto it = sequenceRenders.find(sinkId);
+    if (it == sequenceRenders.end()) return;
+    it->second->progress.cancelled = true;
+    it->second->thread.join();
+    sequenceRenders.erase(it);
+}
+
+void CancelAllSequenceRenders() {
+    for (auto& entry : sequenceRenders) entry.second->progress.cancelled = true;
+    for (auto& entry : sequenceRenders) entry.second->thread.join();
+    sequenceRenders.clear();
+}
+
+void RenderSequenceSinkNode(Node& node, NodeEditorState& state) {
+    BeginInputPin(node.inputSlotId);
+    ImGui::Text("Input");
+    EndInputPin(state);
+
+    // Video file (.mp4, .avi, ...) or numbered images such as out/%04d.png
+    if (ImGui::InputText("##path", state.pathText, IM_ARRAYSIZE(state.pathText))) {
+        node.imagePath = std::string(state.pathText);
+    }
+
+    auto it = sequenceRenders.find(node.id);
+    if (it != sequenceRenders.end()) {
+        const EvalProgress& progress = it->second->progress;
+        char overlay[32];
+        snprintf(overlay, sizeof(overlay), "%d frames", progress.completedItems.load());
+        ImGui::ProgressBar(progress.Fraction(), ImVec2(node.width, 0), overlay);
+        if (ImGui::Button("Cancel")) CancelSequenceRender(node.id);
+    } else if (ImGui::Button("Render Sequence")) {
+        StartSequenceRender(node);
+    }
+
+    if (!state.sequenceStatus.empty()) ImGui::TextDisabled("%s", state.sequenceStatus.c_str());
+}
+
+
+// --- Deleting Nodes and Links ---
+
+// Removes a link; its consumer's results are stale from now on
+void DeleteLink(int linkId) {
+    auto link = std::find_if(links.begin(), links.end(), [&](const Link& l) { return l.id == linkId; });
+    if (link == links.end()) return;
+    if (const Node* consumer = nodes.FindByInputSlot(link->toSlot)) {
+        evalCache.Invalidate(consumer->id, nodes, links);
+        ScheduleLiveUpdate(consumer->id);
+    }
+    links.erase(link);
+}
+
+// Removes a node together with its links, texture, cached results and editor state
+void DeleteNode(int nodeId) {
+    Node* node = FindNodeById(nodeId, nodes);
+    if (!node) return;
+
+    // Downstream results are stale; collect them while the links still lead there
+    evalCache.Invalidate(nodeId, nodes, links);
+    ScheduleLiveUpdate(nodeId);
+    asyncEvaluator.Cancel(nodeId);
+    CancelSequenceRender(nodeId);
+    imageLoader.Cancel(nodeId);
+    if (zoomView.nodeId == nodeId) CloseZoomView();
+    liveDirtyDisplays.erase(nodeId);
+
+    int inputSlot = node->inputSlotId;
+    int outputSlot = node->outputSlotId;
+    links.erase(std::remove_if(links.begin(), links.end(), [&](const Link& link) {
+        return (inputSlot != -1 && link.toSlot == inputSlot) || (outputSlot != -1 && link.fromSlot == outputSlot);
+    }), links.end());
+
+    DeleteTexture(nodes.Images(*node).textureId);
+    memoryManager.ReleaseNode(nodeId);
+    nodes.Erase(node->handle);
+}
+
+// Delete key: removes the selected links, then the selected nodes
+void DeleteSelection() {
+    int linkCount = ImNodes::NumSelectedLinks();
+    if (linkCount > 0) {
+        std::vector<int> linkIds(linkCount);
+        ImNodes::GetSelectedLinks(linkIds.data());
+        for (int linkId : linkIds) DeleteLink(linkId);
+        ImNodes::ClearLinkSelection();
+    }
+
+    int nodeCount = ImNodes::NumSelectedNodes();
+    if (nodeCount > 0) {
+        std::vector<int> nodeIds(nodeCount);
+        ImNodes::GetSelectedNodes(nodeIds.data());
+        for (int nodeId : nodeIds) DeleteNode(nodeId);
+        ImNodes::ClearNodeSelection();
+    }
+}
+
+// Formats the measurements that arrived since last frame into their nodes'
+// title bar text, so drawing a title bar costs no formatting
+static void UpdateNodeProfiles() {
+    static std::map<int, NodeProfile> freshProfiles;
+    asyncEvaluator.TakeNodeProfiles(freshProfiles);
+    for (const auto& entry : freshProfiles) {
+        const Node* node = FindNodeById(entry.first, nodes);
+        if (node) EditorState(*node).profileText = FormatNodeProfile(entry.second);
+    }
+    freshProfiles.clear();
+}
+
+// A node is culled once it has been drawn in full at least once (so its size
+// is known) and its last known rectangle lies outside the visible area
+static bool IsNodeOffscreen(const Node& node, const NodeEditorState& state, const ImVec2& visibleMin, const ImVec2& visibleMax) {
+    if (!cullOffscreenNodes || state.dimensions.x <= 0.0f || state.dimensions.y <= 0.0f) return false;
+    ImVec2 min = ImNodes::GetNodeScreenSpacePos(node.id);
+    ImVec2 max = min + state.dimensions;
+    return max.x < visibleMin.x || max.y < visibleMin.y || min.x > visibleMax.x || min.y > visibleMax.y;
+}
+
+// Stand-in for an off-screen node: keeps its pins where they were last drawn
+// (links still end on them) and its size (so panning it back in doesn't
+// jump), but submits no widgets
+static void RenderCulledNode(const Node& node, const NodeEditorState& state) {
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImVec2 shift = origin - state.drawnOrigin; // The node may have moved since
+    if (node.inputSlotId != -1) {
+        ImGui::SetCursorScreenPos(state.inputPinMin + shift);
+        BeginInputPin(node.inputSlotId);
+        ImGui::Dummy(state.inputPinSize);
+        ImNodes::EndInputAttribute();
+        ImNodes::PopAttributeFlag();
+    }
+    if (node.outputSlotId != -1) {
+        ImGui::SetCursorScreenPos(state.outputPinMin + shift);
+        ImNodes::BeginOutputAttribute(node.outputSlotId);
+        ImGui::Dummy(state.outputPinSize);
+        ImNodes::EndOutputAttribute();
+    }
+    // The node's rectangle is its content plus the padding on each side
+    ImGui::SetCursorScreenPos(origin);
+    ImGui::Dummy(state.dimensions - ImNodes::GetStyle().NodePadding * 2.0f);
+}
 
-// --- Modified RenderNodes Function ---
 void RenderNodes() {
     ImGui::SetNextWindowPos(ImVec2(200, 0), ImGuiCond_Always);
     ImGui::SetNextWindowSize(ImGui::GetIO().DisplaySize - ImVec2(200, 0), ImGuiCond_Always);
@@ -399,12 +1068,54 @@ void RenderNodes() {
     ImGui::Begin("Node Editor Area", nullptr, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
     ImNodes::BeginNodeEditor();
 
+    UpdateNodeProfiles();
+
+    // Visible part of the editor, with a margin so nodes are drawn in full
+    // slightly before they scroll into view
+    const float cullMargin = 50.0f;
+    ImVec2 visibleMin = ImGui::GetWindowPos() - ImVec2(cullMargin, cullMargin);
+    ImVec2 visibleMax = ImGui::GetWindowPos() + ImGui::GetWindowSize() + ImVec2(cullMargin, cullMargin);
+    visibleNodeCount = 0;
+
+    // Results are picked up and requested runs started whether or not the node
+    // is drawn, but only for nodes with something to pick up or start: idle
+    // nodes cost no locking per frame
+    static std::vector<int> readyNodeIds;
+    readyNodeIds.clear();
+    asyncEvaluator.TakeReadyNodes(readyNodeIds);
+    imageLoader.TakeFinishedKeys(readyNodeIds);
+    for (int nodeId : readyNodeIds) {
+        Node* node = nodes.FindById(nodeId);
+        if (!node) continue; // Deleted meanwhile, or the zoom view's key
+        if (node->type == OperationType::ProcessDisplay) UpdateProcessDisplayNode(*node);
+        if (IsSourceNode(*node)) UpdateLoadImageNode(*node);
+    }
+
     for (Node& node : nodes) {
+        NodeEditorState& state = EditorState(node);
+
+        bool requested = node.processingRequested || node.fullResolutionRequested;
+        if (requested && node.type == OperationType::ProcessDisplay) UpdateProcessDisplayNode(node);
+        if (!sequenceRenders.empty() && node.type == OperationType::SequenceSink) UpdateSequenceRender(node);
+
         ImNodes::BeginNode(node.id);
+        ImGui::PushID(node.id);
+
+        if (IsNodeOffscreen(node, state, visibleMin, visibleMax)) {
+            RenderCulledNode(node, state);
+            ImGui::PopID();
+            ImNodes::EndNode();
+            continue;
+        }
+        visibleNodeCount++;
+        state.drawnOrigin = ImGui::GetCursorScreenPos();
 
         // --- Title (Common to all nodes) ---
         ImNodes::BeginNodeTitleBar();
         ImGui::TextUnformatted(node.name.c_str());
+        if (showNodeProfiles && !state.profileText.empty()) {
+            ImGui::TextDisabled("%s", state.profileText.c_str());
+        }
         ImNodes::EndNodeTitleBar();
 
         ImGui::PushItemWidth(node.width); // Set width for inputs inside the node
@@ -412,56 +1123,38 @@ void RenderNodes() {
         // --- Call Specific Renderer based on Type ---
         switch (node.type) {
             case OperationType::LoadImage:
-                RenderLoadImageNode(node);
+            case OperationType::SequenceSource:
+                RenderLoadImageNode(node, state);
                 break;
             case OperationType::Brightness:
+            case OperationType::Contrast:
             case OperationType::Blur:
-                RenderProcessingNode(node);
+            case OperationType::Convolution:
+            case OperationType::Noise:
+                RenderProcessingNode(node, state);
                 break;
-            case OperationType::ProcessDisplay: // New case
-                RenderProcessDisplayNode(node);
+            case OperationType::ProcessDisplay:
+                RenderProcessDisplayNode(node, state);
+                break;
+            case OperationType::SequenceSink:
+                RenderSequenceSinkNode(node, state);
                 break;
-            // Add cases for future node types here
-            // default:
-            //     ImGui::Text("Unknown Node Type"); // Optional: Handle unexpected types
-            //     break;
         }
 
         ImGui::PopItemWidth(); // Matches PushItemWidth
 
-         // --- Resizer (Common to all nodes, position might need adjustment) ---
-        // This positioning might need tweaking depending on the content of each node type.
-        // Consider making the resizer positioning relative to the node's bottom-right corner.
-        ImVec2 node_pos = ImNodes::GetNodeDimensions(node.id); // Requires ImNodes > v0.4 maybe? check version
-        // Fallback if GetNodeDimensions isn't available or suitable:
-        // ImVec2 grip_pos = ImGui::GetCursorScreenPos(); // This depends heavily on layout flow
-        // Alternative: Position relative to node position from ImNodes if available
-
-        // Simple positioning based on current cursor (might overlap content)
-        // ImGui::SetCursorScreenPos(ImVec2(ImGui::GetItemRectMin().x + node.width - 10, ImGui::GetItemRectMax().y - 10)); // Example positioning attempt
-
-        // Keeping original logic for now, but be aware it might need refinement:
-        ImVec2 current_cursor = ImGui::GetCursorScreenPos(); // Where cursor is *after* rendering node content
-        ImVec2 node_screen_pos = ImNodes::GetNodeScreenSpacePos(node.id);
-        float node_height = ImGui::GetItemRectSize().y; // Height of the *last* item added
-        // It's hard to get the *total* node height accurately without ImNodes helpers
-        // This resizer logic might be better placed *outside* the specific render functions
-        // or use a fixed offset if node heights are predictable.
-
-        // Let's try putting it consistently after PopItemWidth but before EndNode
-        ImGui::SameLine(); // Try to place it on the same line if possible? May not work well.
-        ImGui::PushID(node.id); // Unique ID for each grip
-        // Use a small invisible button as a grab handle area
+        // --- Resizer (Common to all nodes) ---
+        ImGui::SameLine();
         ImGui::SetCursorPosX(ImGui::GetCursorPosX() + node.width - 20); // Move towards the right edge
         if (ImGui::Button(">", ImVec2(20, 20))) {}; // Resizer visual (can be styled/made invisible)
         if (ImGui::IsItemActive()) {
             node.width += ImGui::GetIO().MouseDelta.x;
             node.width = ImClamp(node.width, 100.0f, 300.0f); // Clamp to a reasonable range
         }
-        ImGui::PopID();
-
 
+        ImGui::PopID();
         ImNodes::EndNode();
+        state.dimensions = ImNodes::GetNodeDimensions(node.id);
     }
 
     // Render links (unchanged)
@@ -477,12 +1170,103 @@ if (ImNodes::IsLinkCreated(&startAttr, &endAttr)) {
     handleNodeConnection(startAttr, endAttr);
 }
 
-    // Check for deleted links/nodes (You would add this logic here if needed)
-    // ...
+    // Check for deleted links/nodes
+    int destroyedLink;
+    if (ImNodes::IsLinkDestroyed(&destroyedLink)) {
+        DeleteLink(destroyedLink);
+    }
+    // Not while a text field has focus, Delete edits the text there
+    bool editorFocused = ImGui::IsWindowFocused(ImGuiFocusedFlags_RootAndChildWindows) && !ImGui::GetIO().WantTextInput;
+    if (editorFocused && ImGui::IsKeyPressed(ImGuiKey_Delete)) {
+        DeleteSelection();
+    }
 
     ImGui::End(); // End Node Editor Area window
 }
 
+// Replaces the current graph with the one stored at path
+void LoadGraphIntoEditor(const std::string& path) {
+    NodeStore loadedNodes;
+    std::vector<Link> loadedLinks;
+    if (!LoadGraph(path, loadedNodes, loadedLinks)) return;
+
+    for (Node& node : nodes) {
+        DeleteTexture(nodes.Images(node).textureId);
+    }
+    asyncEvaluator.CancelAll();
+    CancelAllSequenceRenders();
+    CloseZoomView();
+    imageLoader.CancelAll();
+    liveDirtyDisplays.clear();
+    editorStates.clear();
+    evalCache.Clear();
+    memoryManager.Clear();
+
+    nodes = std::move(loadedNodes);
+    links = std::move(loadedLinks);
+
+    // Keep new ids clear of the loaded ones
+    for (const Node& node : nodes) {
+        nodeCounter = std::max(nodeCounter, node.id + 1);
+        slotCounter = std::max({slotCounter, node.inputSlotId + 1, node.outputSlotId + 1});
+        ImNodes::SetNodeGridSpacePos(node.id, node.position);
+    }
+    for (const Link& link : links) {
+        linkCounter = std::max(linkCounter, link.id + 1);
+    }
+
+    for (Node& node : nodes) {
+        if (IsSourceNode(node)) LoadImageIntoNode(node);
+    }
+    std::cout << "Loaded graph from " << path << " (" << nodes.size() << " nodes, " << links.size() << " links)" << std::endl;
+}
+
+// Evaluates the connected ProcessDisplay nodes among candidateIds in one
+// background plan, so shared upstream nodes run once and independent
+// branches run in parallel
+void ProcessDisplays(const std::vector<int>& candidateIds) {
+    std::vector<int> displayIds;
+    std::vector<int> targetIds;
+    for (int candidateId : candidateIds) {
+        Node* node = FindNodeById(candidateId, nodes);
+        if (!node || node->type != OperationType::ProcessDisplay) continue;
+        const Link* inputLink = FindLinkConnectedToInput(node->inputSlotId, links);
+        Node* prevNode = inputLink ? FindNodeByOutputAttr(inputLink->fromSlot, nodes) : nullptr;
+        if (!prevNode) continue;
+        displayIds.push_back(node->id);
+        targetIds.push_back(prevNode->id);
+    }
+    if (targetIds.empty()) return;
+
+    EvalOptions options = CurrentEvalOptions();
+    for (size_t i = 0; i < displayIds.size(); i++) {
+        Node* display = FindNodeById(displayIds[i], nodes);
+        display->pendingPreview = PreviewDownscales(targetIds[i], options.previewMaxSize);
+        display->saveRequested = false;
+    }
+    std::cout << "--- Processing Triggered for " << targetIds.size() << " display nodes ---" << std::endl;
+    for (int targetId : targetIds) TouchUpstreamSources(targetId);
+    asyncEvaluator.Start(displayIds, targetIds, nodes, links, options);
+}
+
+void ProcessAllDisplays() {
+    std::vector<int> displayIds;
+    for (const Node& node : nodes) {
+        if (node.type == OperationType::ProcessDisplay) displayIds.push_back(node.id);
+    }
+    ProcessDisplays(displayIds);
+}
+
+// Starts the pending live evaluation once edits have settled, called every frame.
+// Every dirty display is handed to the new run (or dropped when unconnected, it
+// has nothing to show), so none is left waiting on a run that was superseded.
+void UpdateLiveEvaluation() {
+    if (liveDirtyDisplays.empty() || ImGui::GetTime() - liveLastEditTime < liveDebounceSeconds) return;
+    std::vector<int> displayIds(liveDirtyDisplays.begin(), liveDirtyDisplays.end());
+    liveDirtyDisplays.clear();
+    ProcessDisplays(displayIds);
+}
+
 void ShowSidePanel() {
     ImGui::SetNextWindowPos(ImVec2(0, 0), ImGuiCond_Always);
     ImGui::SetNextWindowSize(ImVec2(200, ImGui::GetIO().DisplaySize.y), ImGuiCond_Always);
@@ -494,12 +1278,131 @@ void ShowSidePanel() {
     if (ImGui::Button("Add Brightness Node")) {
         AddNode(OperationType::Brightness, "Brightness Node", ImVec2(250, 200));
     }
+    if (ImGui::Button("Add Contrast Node")) {
+        AddNode(OperationType::Contrast, "Contrast Node", ImVec2(250, 250));
+    }
+    if (ImGui::Button("Add Convolution Node")) {
+        AddNode(OperationType::Convolution, "Convolution Node", ImVec2(250, 350));
+    }
+    if (ImGui::Button("Add Noise Node")) {
+        AddNode(OperationType::Noise, "Noise Node", ImVec2(250, 375));
+    }
     if (ImGui::Button("Add Load Image Node")) {
         AddNode(OperationType::LoadImage, "Load Image", ImVec2(250, 300));
     }
     if (ImGui::Button("Add Process/Display Node")) {
         AddNode(OperationType::ProcessDisplay, "Process & Display", ImVec2(250, 400)); // Adjust position
     }
+    if (ImGui::Button("Add Sequence Source")) {
+        AddNode(OperationType::SequenceSource, "Sequence Source", ImVec2(250, 300));
+    }
+    if (ImGui::Button("Add Sequence Output")) {
+        AddNode(OperationType::SequenceSink, "Sequence Output", ImVec2(250, 400));
+    }
+
+    // --- Evaluation ---
+    ImGui::Separator();
+    ImGui::Text("Max threads (0 = all)");
+    ImGui::PushItemWidth(-1);
+    ImGui::SliderInt("##threads", &evalConcurrency, 0, static_cast<int>(ThreadPool::shared().size()));
+    ImGui::PopItemWidth();
+    ImGui::Checkbox("Tiled evaluation", &tiledEvaluation);
+    if (tiledEvaluation) {
+        ImGui::PushItemWidth(-1);
+        if (ImGui::InputInt("##tileSize", &evalTileSize, 256, 1024)) {
+            evalTileSize = ImClamp(evalTileSize, 64, 16384);
+        }
+        ImGui::PopItemWidth();
+    }
+    ImGui::Checkbox("Cache intermediates", &cacheIntermediates);
+    if (ImGui::Checkbox("Preview mode", &previewMode)) RefreshSourceDecodes();
+    if (previewMode) {
+        ImGui::PushItemWidth(-1);
+        if (ImGui::InputInt("##previewSize", &previewSize, 128, 512)) {
+            previewSize = ImClamp(previewSize, 64, 8192);
+            RefreshSourceDecodes(); // Each request supersedes the node's previous one
+        }
+        ImGui::PopItemWidth();
+    }
+    if (ImGui::Checkbox("Live mode", &liveMode) && !liveMode) {
+        liveDirtyDisplays.clear();
+    }
+    if (ImGui::Button("Process All Displays")) {
+        ProcessAllDisplays();
+    }
+
+    // --- Disk Cache ---
+    ImGui::Separator();
+    static char diskCachePath[256] = "node_cache";
+    static int diskCacheSizeMB = 4096;
+    ImGui::Checkbox("Disk cache", &useDiskCache);
+    if (useDiskCache) {
+        ImGui::PushItemWidth(-1);
+        bool reopen = ImGui::InputText("##diskCachePath", diskCachePath, IM_ARRAYSIZE(diskCachePath), ImGuiInputTextFlags_EnterReturnsTrue);
+        if (ImGui::InputInt("##diskCacheSize", &diskCacheSizeMB, 256, 1024)) {
+            diskCacheSizeMB = ImClamp(diskCacheSizeMB, 64, 1 << 20);
+            if (diskCache) diskCache->SetMaxBytes(static_cast<uint64_t>(diskCacheSizeMB) << 20);
+        }
+        ImGui::PopItemWidth();
+        if (!diskCache || (reopen && diskCache->directory() != diskCachePath)) {
+            if (diskCache) retiredDiskCaches.push_back(std::move(diskCache));
+            diskCache = std::make_unique<DiskCache>(diskCachePath, static_cast<uint64_t>(diskCacheSizeMB) << 20);
+        }
+        DiskCache::Stats stats = diskCache->stats();
+        ImGui::TextDisabled("%llu hits, %llu misses", static_cast<unsigned long long>(stats.hits),
+                            static_cast<unsigned long long>(stats.misses));
+        ImGui::TextDisabled("%zu entries, %llu MB", stats.entries, static_cast<unsigned long long>(stats.totalBytes >> 20));
+        if (ImGui::Button("Clear Disk Cache")) diskCache->Clear();
+    }
+
+    // --- Memory ---
+    ImGui::Separator();
+    ImGui::Text("Memory budget (MB)");
+    ImGui::PushItemWidth(-1);
+    if (ImGui::InputInt("##memoryBudget", &memoryBudgetMB, 256, 1024)) {
+        memoryBudgetMB = ImClamp(memoryBudgetMB, 64, 1 << 20);
+        memoryManager.SetBudget(static_cast<uint64_t>(memoryBudgetMB) << 20);
+    }
+    ImGui::PopItemWidth();
+    MemoryManager::Stats memory = memoryManager.stats();
+    char memoryText[64];
+    snprintf(memoryText, sizeof(memoryText), "%llu / %d MB", static_cast<unsigned long long>(memory.usedBytes >> 20), memoryBudgetMB);
+    ImGui::ProgressBar(static_cast<float>(memory.usedBytes) / std::max<uint64_t>(1, memory.budgetBytes), ImVec2(-1, 0), memoryText);
+    ImGui::TextDisabled("Peak %llu MB", static_cast<unsigned long long>(memory.peakBytes >> 20));
+    ImGui::TextDisabled("%llu evicted (%llu MB)", static_cast<unsigned long long>(memory.evictions),
+                        static_cast<unsigned long long>(memory.evictedBytes >> 20));
+
+    // --- Profiling ---
+    ImGui::Separator();
+    ImGui::Checkbox("Show node timings", &showNodeProfiles);
+    ImGui::Checkbox("Cull off-screen nodes", &cullOffscreenNodes);
+    ImGui::TextDisabled("%d of %d nodes drawn", visibleNodeCount, static_cast<int>(nodes.size()));
+    static char tracePath[256] = "eval_trace.json";
+    ImGui::PushItemWidth(-1);
+    ImGui::InputText("##tracePath", tracePath, IM_ARRAYSIZE(tracePath));
+    ImGui::PopItemWidth();
+    if (ImGui::Button("Export Trace")) {
+        if (asyncEvaluator.WriteLastTrace(tracePath)) {
+            std::cout << "Wrote trace of the last evaluation to " << tracePath << std::endl;
+        }
+    }
+
+    // --- Graph Save/Load (shared format with the headless batch runner) ---
+    ImGui::Separator();
+    static char graphPath[256] = "graph.txt";
+    ImGui::PushItemWidth(-1);
+    ImGui::InputText("##graphPath", graphPath, IM_ARRAYSIZE(graphPath));
+    ImGui::PopItemWidth();
+    if (ImGui::Button("Save Graph")) {
+        for (Node& node : nodes) node.position = ImNodes::GetNodeGridSpacePos(node.id);
+        if (SaveGraph(graphPath, nodes, links)) {
+            std::cout << "Saved graph to " << graphPath << std::endl;
+        }
+    }
+    ImGui::SameLine();
+    if (ImGui::Button("Load Graph")) {
+        LoadGraphIntoEditor(graphPath);
+    }
 
     ImGui::End();
 }
@@ -507,9 +1410,86 @@ void ShowSidePanel() {
 void RenderUI() {
     ShowSidePanel();
     RenderNodes();
+    ShowZoomView();
+    UpdateLiveEvaluation();
+    EnforceMemoryBudget();
+}
+
+// --- Frame Benchmark ---
+// --bench-frames builds a synthetic graph and times the editor's frames, to
+// keep the frame loop honest on graphs far larger than anyone builds by hand.
+
+// Chains of LoadImage -> 48 processing nodes -> ProcessDisplay, laid out in a
+// grid. Sources have no image, nothing is evaluated; only the UI is measured.
+void BuildSyntheticGraph(int nodeCount) {
+    const OperationType processingTypes[] = {OperationType::Blur, OperationType::Brightness, OperationType::Contrast, OperationType::Noise};
+    const int chainLength = 50;
+    const float spacingX = 200.0f, spacingY = 150.0f;
+
+    for (int chain = 0; chain * chainLength < nodeCount; chain++) {
+        int previousOutput = -1;
+        for (int step = 0; step < chainLength && chain * chainLength + step < nodeCount; step++) {
+            Node node;
+            node.id = nodeCounter++;
+            node.position = ImVec2(step * spacingX, chain * spacingY);
+            if (step == 0) {
+                node.type = OperationType::LoadImage;
+                node.name = "Load Image";
+                node.imagePath = "";
+            } else if (step == chainLength - 1) {
+                node.type = OperationType::ProcessDisplay;
+                node.name = "Process & Display";
+            } else {
+                node.type = processingTypes[step % 4];
+                node.name = "Node " + std::to_string(node.id);
+                node.value = node.type == OperationType::Blur ? 3.0f : 1.0f;
+                if (node.type == OperationType::Noise) node.seed = static_cast<uint32_t>(node.id);
+            }
+            if (node.type != OperationType::LoadImage) node.inputSlotId = slotCounter++;
+            if (node.type != OperationType::ProcessDisplay) node.outputSlotId = slotCounter++;
+
+            if (previousOutput != -1) links.push_back({linkCounter++, previousOutput, node.inputSlotId});
+            previousOutput = node.outputSlotId;
+            ImNodes::SetNodeGridSpacePos(node.id, node.position);
+            nodes.Insert(std::move(node));
+        }
+    }
+}
+
+// Prints frame time statistics of samples (milliseconds)
+void ReportFrameTimes(std::vector<double> samples) {
+    if (samples.empty()) return;
+    std::sort(samples.begin(), samples.end());
+    double sum = 0.0;
+    for (double sample : samples) sum += sample;
+    auto percentile = [&](double p) { return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))]; };
+    std::cout << "Frames: " << samples.size() << ", nodes: " << nodes.size() << ", drawn: " << visibleNodeCount
+              << (cullOffscreenNodes ? "" : " (culling off)") << std::endl;
+    std::cout << "Frame time ms: mean " << sum / samples.size() << ", median " << percentile(0.5)
+              << ", p95 " << percentile(0.95) << ", p99 " << percentile(0.99) << ", max " << samples.back() << std::endl;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // Usage: node_editor [--bench-frames [nodes] [frames]] [--no-cull]
+    bool benchFrames = false;
+    int benchNodeCount = 5000;
+    int benchFrameCount = 300;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--bench-frames") {
+            benchFrames = true;
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) benchNodeCount = std::atoi(argv[++i]);
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) benchFrameCount = std::atoi(argv[++i]);
+        } else if (arg == "--no-cull") {
+            cullOffscreenNodes = false;
+        } else {
+            std::cerr << "Unknown argument " << arg << std::endl;
+            return -1;
+        }
+    }
+
+    evalCache.memory = &memoryManager; // Cached results count against the memory budget too
+
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW" << std::endl;
         return -1;
@@ -528,7 +1508,7 @@ int main() {
         return -1;
     }
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);
+    glfwSwapInterval(benchFrames ? 0 : 1); // Unthrottled when timing frames
 
     IMGUI_CHECKVERSION();
     ImGui::CreateContext();
@@ -539,7 +1519,14 @@ int main() {
     ImGui_ImplGlfw_InitForOpenGL(window, true);
     ImGui_ImplOpenGL3_Init(glsl_version);
 
+    if (benchFrames) BuildSyntheticGraph(benchNodeCount);
+    const int warmupFrames = 10; // Lets every node get drawn once and its size recorded
+    int frameIndex = 0;
+    std::vector<double> frameTimes;
+    frameTimes.reserve(benchFrameCount);
+
     while (!glfwWindowShouldClose(window)) {
+        double frameStart = glfwGetTime();
         glfwPollEvents();
 
         ImGui_ImplOpenGL3_NewFrame();
@@ -557,7 +1544,17 @@ int main() {
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
         glfwSwapBuffers(window);
+
+        if (benchFrames) {
+            if (frameIndex++ >= warmupFrames) frameTimes.push_back((glfwGetTime() - frameStart) * 1000.0);
+            if (static_cast<int>(frameTimes.size()) >= benchFrameCount) break;
+        }
     }
+    if (benchFrames) ReportFrameTimes(frameTimes);
+
+    asyncEvaluator.Shutdown();
+    CancelAllSequenceRenders();
+    imageLoader.CancelAll(); // Queued decodes are skipped, running ones finish before exit
 
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
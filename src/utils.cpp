@@ -1,15 +1,20 @@
-#include "_Node.h"
+#include "utils.h"
 #include "ImageProcessor.h"
-#include <map> // For memoization cache
+#include "ImageLoader.h"
+#include "ThreadPool.h"
+#include "MatPool.h"
+#include "ConvolutionEngine.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <cstring>
+#include <functional>
+#include <unordered_set>
 
 // Find a node by its unique ID
-Node* FindNodeById(int nodeId, std::vector<Node>& nodes) {
-    for (Node& node : nodes) {
-        if (node.id == nodeId) {
-            return &node;
-        }
-    }
-    return nullptr;
+Node* FindNodeById(int nodeId, NodeStore& nodes) {
+    return nodes.FindById(nodeId);
 }
 
 // Find the link connected TO a specific input attribute ID
@@ -23,45 +28,564 @@ const Link* FindLinkConnectedToInput(int inputAttrId, std::vector<Link>& links)
 }
 
 // Find the node whose OUTPUT attribute matches the given ID
-Node* FindNodeByOutputAttr(int outputAttrId, std::vector<Node>& nodes) {
-    for (Node& node : nodes) {
-        if (node.outputSlotId == outputAttrId) {
-            return &node;
+Node* FindNodeByOutputAttr(int outputAttrId, NodeStore& nodes) {
+    return nodes.FindByOutputSlot(outputAttrId);
+}
+
+// Mixes v into seed (FNV-1a over the bytes of v)
+static uint64_t HashCombine(uint64_t seed, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        seed ^= (v >> (i * 8)) & 0xff;
+        seed *= 1099511628211ULL;
+    }
+    return seed;
+}
+
+// Cache key of a node given the key of its upstream result (0 for sources)
+static uint64_t ComputeCacheKey(const Node& node, uint64_t upstreamKey) {
+    uint64_t key = 14695981039346656037ULL;
+    key = HashCombine(key, static_cast<uint64_t>(node.id));
+    key = HashCombine(key, static_cast<uint64_t>(node.type));
+    key = HashCombine(key, static_cast<uint64_t>(node.version));
+    if (node.value.has_value()) {
+        uint32_t bits;
+        float value = node.value.value();
+        memcpy(&bits, &value, sizeof(bits));
+        key = HashCombine(key, bits);
+    }
+    if (node.imagePath.has_value()) {
+        key = HashCombine(key, std::hash<std::string>{}(node.imagePath.value()));
+    }
+    if (node.kernelText.has_value()) {
+        key = HashCombine(key, std::hash<std::string>{}(node.kernelText.value()));
+    }
+    if (node.seed.has_value()) {
+        key = HashCombine(key, node.seed.value());
+    }
+    return HashCombine(key, upstreamKey);
+}
+
+// --- Content keys ---
+// Unlike cache keys, content keys leave out node ids and edit versions and
+// start from the source pixels, so equal work in another session, another
+// graph or a batch run gets the same key. Bump diskCacheVersion whenever an
+// operation's output changes, so results of older builds are not reused.
+static const uint64_t diskCacheVersion = 1;
+
+// FNV-1a over a byte range, stable across builds unlike std::hash
+static uint64_t HashBytes(uint64_t seed, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        seed ^= bytes[i];
+        seed *= 1099511628211ULL;
+    }
+    return seed;
+}
+
+// Hash of an image's shape and pixels, 8 bytes per multiply so a 40 MP image
+// takes tens of milliseconds
+static uint64_t ImageContentHash(const cv::Mat& image) {
+    uint64_t hash = HashCombine(14695981039346656037ULL, static_cast<uint64_t>(image.rows));
+    hash = HashCombine(hash, static_cast<uint64_t>(image.cols));
+    hash = HashCombine(hash, static_cast<uint64_t>(image.type()));
+    size_t rowBytes = image.cols * image.elemSize();
+    for (int y = 0; y < image.rows; y++) {
+        const uchar* row = image.ptr(y);
+        size_t i = 0;
+        for (; i + 8 <= rowBytes; i += 8) {
+            uint64_t word;
+            memcpy(&word, row + i, sizeof(word));
+            hash = (hash ^ word) * 0x9E3779B97F4A7C15ULL;
+            hash ^= hash >> 29;
         }
+        hash = HashBytes(hash, row + i, rowBytes - i);
+    }
+    return hash;
+}
+
+// Content key of a source image as a run sees it (proxy or full resolution)
+static uint64_t SourceContentKey(const cv::Mat& image) {
+    return HashCombine(ImageContentHash(image), diskCacheVersion);
+}
+
+// Content key of a node's result given its input's content key, 0 if the input's is unknown.
+// scale matters because previews scale blur kernels with it.
+static uint64_t ComputeContentKey(const Node& node, uint64_t inputContentKey, double scale) {
+    if (inputContentKey == 0) return 0;
+    uint64_t key = HashCombine(inputContentKey, static_cast<uint64_t>(node.type));
+    uint64_t scaleBits;
+    memcpy(&scaleBits, &scale, sizeof(scaleBits));
+    key = HashCombine(key, scaleBits);
+    if (node.value.has_value()) {
+        uint32_t bits;
+        float value = node.value.value();
+        memcpy(&bits, &value, sizeof(bits));
+        key = HashCombine(key, bits);
+    }
+    if (node.kernelText.has_value()) key = HashBytes(key, node.kernelText->data(), node.kernelText->size());
+    if (node.seed.has_value()) key = HashCombine(key, node.seed.value());
+    return key == 0 ? 1 : key; // 0 means unknown
+}
+
+EvalCache::Resolution CacheResolution(const EvalOptions& options) {
+    return options.previewMaxSize > 0 ? EvalCache::Resolution::Preview : EvalCache::Resolution::Full;
+}
+
+static MemoryManager::Kind CachedKind(EvalCache::Resolution resolution) {
+    return resolution == EvalCache::Resolution::Preview ? MemoryManager::Kind::CachedPreview : MemoryManager::Kind::CachedResult;
+}
+
+bool EvalCache::Lookup(int nodeId, Resolution resolution, uint64_t key, cv::Mat& image, uint64_t* contentKey) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<int, CacheEntry>& slot = entries[static_cast<int>(resolution)];
+    auto cached = slot.find(nodeId);
+    if (cached == slot.end() || cached->second.key != key) return false;
+    image = cached->second.image;
+    if (contentKey) *contentKey = cached->second.contentKey;
+    if (memory) memory->Touch(CachedKind(resolution), nodeId);
+    return true;
+}
+
+void EvalCache::Store(int nodeId, Resolution resolution, uint64_t key, const cv::Mat& image, uint64_t contentKey) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[static_cast<int>(resolution)][nodeId] = {key, image, contentKey};
+    if (memory) memory->Track(CachedKind(resolution), nodeId, image);
+}
+
+void EvalCache::Erase(int nodeId, Resolution resolution) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries[static_cast<int>(resolution)].erase(nodeId);
+    if (memory) memory->Release(CachedKind(resolution), nodeId);
+}
+
+void EvalCache::Clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Resolution resolution : {Resolution::Full, Resolution::Preview}) {
+        std::map<int, CacheEntry>& slot = entries[static_cast<int>(resolution)];
+        if (memory) {
+            for (const auto& entry : slot) memory->Release(CachedKind(resolution), entry.first);
+        }
+        slot.clear();
+    }
+}
+
+void EvalCache::Invalidate(int nodeId, NodeStore& nodes, std::vector<Link>& links) {
+    std::vector<int> affected = CollectDownstreamNodes(nodeId, nodes, links);
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Resolution resolution : {Resolution::Full, Resolution::Preview}) {
+        for (int affectedId : affected) {
+            if (entries[static_cast<int>(resolution)].erase(affectedId) && memory) memory->Release(CachedKind(resolution), affectedId);
+        }
+    }
+}
+
+std::vector<int> CollectDownstreamNodes(int nodeId, NodeStore& nodes, std::vector<Link>& links) {
+    // Links by the output they leave from, so the walk costs O(nodes + links) rather than a scan per node
+    std::unordered_multimap<int, int> toSlotsByFromSlot;
+    toSlotsByFromSlot.reserve(links.size());
+    for (const Link& link : links) toSlotsByFromSlot.emplace(link.fromSlot, link.toSlot);
+
+    std::vector<int> affected;
+    std::vector<int> pending = {nodeId};
+    std::unordered_set<int> visited;
+    while (!pending.empty()) {
+        int currentId = pending.back();
+        pending.pop_back();
+        if (!visited.insert(currentId).second) continue;
+        affected.push_back(currentId);
+
+        Node* node = nodes.FindById(currentId);
+        if (!node || node->outputSlotId == -1) continue;
+
+        // Queue every node fed by this node's output
+        auto range = toSlotsByFromSlot.equal_range(node->outputSlotId);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (Node* consumer = nodes.FindByInputSlot(it->second)) pending.push_back(consumer->id);
+        }
+    }
+    return affected;
+}
+
+GraphIndex BuildGraphIndex(std::vector<Link>& links) {
+    GraphIndex index;
+    index.linkByInputSlot.reserve(links.size());
+    for (const Link& link : links) {
+        index.linkByInputSlot[link.toSlot] = &link;
+    }
+    return index;
+}
+
+// Per-pixel operations that can be folded into a single pass
+static bool IsPointOperation(OperationType type) {
+    return type == OperationType::Brightness || type == OperationType::Contrast;
+}
+
+// Operations whose output pixel depends only on the same input pixel, safe to run with dst == input
+static bool WritesInPlace(OperationType type) {
+    return IsPointOperation(type) || type == OperationType::Noise;
+}
+
+static PointOp ToPointOp(const Node& node) {
+    float value = node.value.value_or(0.0f);
+    if (node.type == OperationType::Contrast) return PointOp::contrast(value);
+    return PointOp::brightness(static_cast<int>(value));
+}
+
+// Merges each point operation into its consumer when that consumer is its only
+// reader and is a point operation too, so a chain costs one pass over the image
+static void FusePointOperations(ExecutionPlan& plan) {
+    size_t count = plan.steps.size();
+    std::vector<int> consumerCount(count, 0);
+    std::vector<int> consumerOf(count, -1);
+    std::vector<bool> isTarget(count, false);
+    for (size_t i = 0; i < count; i++) {
+        int producer = plan.steps[i].inputStep;
+        if (producer == -1) continue;
+        consumerCount[producer]++;
+        consumerOf[producer] = static_cast<int>(i);
+    }
+    for (int target : plan.targetSteps) isTarget[target] = true;
+
+    // Targets keep their own result, everything else in a chain can be skipped
+    std::vector<bool> absorbed(count, false);
+    bool anyAbsorbed = false;
+    for (size_t i = 0; i < count; i++) {
+        absorbed[i] = IsPointOperation(plan.steps[i].node->type) && !isTarget[i] && consumerCount[i] == 1
+            && IsPointOperation(plan.steps[consumerOf[i]].node->type);
+        anyAbsorbed = anyAbsorbed || absorbed[i];
+    }
+    if (!anyAbsorbed) return;
+
+    std::vector<int> remap(count, -1);
+    std::vector<PlanStep> steps;
+    for (size_t i = 0; i < count; i++) {
+        if (absorbed[i]) continue;
+
+        PlanStep step = plan.steps[i];
+        if (step.inputStep != -1 && absorbed[step.inputStep]) {
+            std::vector<Node*> chain = {step.node};
+            int producer = step.inputStep;
+            while (producer != -1 && absorbed[producer]) {
+                chain.push_back(plan.steps[producer].node);
+                producer = plan.steps[producer].inputStep;
+            }
+            step.fusedNodes.assign(chain.rbegin(), chain.rend());
+            step.inputStep = producer;
+        }
+        if (step.inputStep != -1) step.inputStep = remap[step.inputStep];
+
+        remap[i] = static_cast<int>(steps.size());
+        steps.push_back(step);
+    }
+
+    for (int& target : plan.targetSteps) target = remap[target];
+    plan.steps = std::move(steps);
+}
+
+// Memory planner: a step's result is live until its last consumer ran, targets
+// live until the run returns. Counting consumers works for any execution order.
+static void PlanLifetimes(ExecutionPlan& plan) {
+    for (PlanStep& step : plan.steps) {
+        step.consumerCount = 0;
+        step.isTarget = false;
+    }
+    for (const PlanStep& step : plan.steps) {
+        if (step.inputStep != -1) plan.steps[step.inputStep].consumerCount++;
+    }
+    for (int target : plan.targetSteps) plan.steps[target].isTarget = true;
+}
+
+ExecutionPlan CompileGraph(const std::vector<int>& targetIds, NodeStore& nodes, std::vector<Link>& links) {
+    ExecutionPlan plan;
+    GraphIndex index = BuildGraphIndex(links);
+
+    // Iterative depth-first walk towards the sources, a step is emitted once its producer has been
+    enum class Mark { InProgress, Done };
+    std::unordered_map<int, Mark> marks;
+    std::unordered_map<int, int> stepOfNode;
+
+    for (int targetId : targetIds) {
+        std::vector<Node*> stack;
+        Node* target = nodes.FindById(targetId);
+        if (!target) {
+            plan.error = "Node not found during processing: " + std::to_string(targetId);
+            return plan;
+        }
+        if (!marks.count(targetId)) stack.push_back(target);
+
+        while (!stack.empty()) {
+            Node* node = stack.back();
+            Node* producer = nullptr;
+            if (node->inputSlotId != -1) {
+                auto link = index.linkByInputSlot.find(node->inputSlotId);
+                if (link != index.linkByInputSlot.end()) producer = nodes.FindByOutputSlot(link->second->fromSlot);
+            }
+
+            auto mark = marks.find(node->id);
+            if (mark == marks.end()) {
+                // First visit: make sure the producer is emitted before this node
+                marks[node->id] = Mark::InProgress;
+                if (producer) {
+                    auto producerMark = marks.find(producer->id);
+                    if (producerMark != marks.end() && producerMark->second == Mark::InProgress) {
+                        plan.error = "Graph contains a cycle through node " + std::to_string(producer->id);
+                        return plan;
+                    }
+                    if (producerMark == marks.end()) stack.push_back(producer);
+                }
+                continue;
+            }
+
+            // Second visit: the producer is done, emit this node
+            stack.pop_back();
+            if (mark->second == Mark::Done) continue;
+            mark->second = Mark::Done;
+
+            PlanStep step;
+            step.node = node;
+            step.images = &nodes.Images(*node);
+            step.inputStep = producer ? stepOfNode[producer->id] : -1;
+            stepOfNode[node->id] = static_cast<int>(plan.steps.size());
+            plan.steps.push_back(step);
+        }
+
+        plan.targetSteps.push_back(stepOfNode[targetId]);
+    }
+
+    FusePointOperations(plan);
+    PlanLifetimes(plan);
+    plan.valid = true;
+    return plan;
+}
+
+// Kernel size a Blur node runs with
+static int BlurKernelSize(const Node& node, bool warn) {
+    float value = node.value.value_or(0.0f);
+    int kernelSize = static_cast<int>(value);
+    if (kernelSize <= 0 || kernelSize % 2 == 0) {
+        kernelSize = 3; // Default to 3 if value is invalid
+        if (warn) std::cerr << "Warning: Invalid blur kernel size (" << value << ") for node " << node.id << ". Using 3." << std::endl;
+    }
+    return kernelSize;
+}
+
+// Kernel a Convolution node runs with: its parsed kernel text times its value.
+// Returns false (and warns) if the text does not parse.
+static bool ConvolutionKernel(const Node& node, cv::Mat& kernel, bool warn) {
+    std::string error;
+    if (!ParseConvolutionKernel(node.kernelText.value_or(""), kernel, error)) {
+        if (warn) std::cerr << "Error: Invalid convolution kernel for node " << node.id << ": " << error << std::endl;
+        return false;
+    }
+    kernel *= node.value.value_or(1.0f);
+    return true;
+}
+
+// Blur kernel size for an image downscaled by scale, kept odd and at least 1
+static int ScaleKernelSize(int kernelSize, double scale) {
+    if (scale >= 1.0) return kernelSize;
+    int scaled = static_cast<int>(kernelSize * scale + 0.5);
+    return std::max(1, (scaled / 2) * 2 + 1);
+}
+
+// User kernel for an image downscaled by scale: resampled to the footprint
+// it has on the proxy, with its sum kept, so a blur stays a blur of the same
+// strength and an edge kernel keeps summing to zero
+static cv::Mat ScaleKernel(const cv::Mat& kernel, double scale) {
+    if (scale >= 1.0) return kernel;
+    cv::Size size(ScaleKernelSize(kernel.cols, scale), ScaleKernelSize(kernel.rows, scale));
+    if (size == kernel.size()) return kernel;
+
+    double sum = cv::sum(kernel)[0];
+    cv::Mat scaled;
+    cv::resize(kernel, scaled, size, 0, 0, cv::INTER_AREA); // Averages, the sum shrinks with the area
+    scaled *= static_cast<double>(kernel.total()) / scaled.total();
+    double scaledSum = cv::sum(scaled)[0];
+    if (std::abs(sum) > 1e-6 && std::abs(scaledSum) > 1e-6) scaled *= sum / scaledSum;
+    return scaled;
+}
+
+// Runs the operation of a processing node on its input image
+// scale is the input's resolution relative to the full-size source (< 1 for previews)
+// origin is where the input's top-left pixel sits in the full image (non-zero for tiles)
+// dst is reused if it already has the input's size and type
+static void ApplyNodeOperation(const Node& node, const cv::Mat& inputImage, cv::Mat& dst, bool verbose = true, double scale = 1.0,
+                               cv::Point origin = cv::Point()) {
+    float value = node.value.value_or(0.0f); // Get value safely
+
+    if (node.type == OperationType::Brightness) {
+        ImageProcessor::applyBrightness(inputImage, dst, static_cast<int>(value)); // Assuming value is brightness offset
+    } else if (node.type == OperationType::Contrast) {
+        ImageProcessor::applyContrast(inputImage, dst, value);
+    } else if (node.type == OperationType::Blur) {
+        ImageProcessor::applyBlur(inputImage, dst, ScaleKernelSize(BlurKernelSize(node, verbose), scale));
+    } else if (node.type == OperationType::Convolution) {
+        // User kernels are defined in full-resolution pixels, previews resample them like Blur
+        cv::Mat kernel;
+        if (!ConvolutionKernel(node, kernel, verbose)) {
+            dst.release();
+            return;
+        }
+        kernel = ScaleKernel(kernel, scale);
+        if (verbose) {
+            std::cout << "Processing: Convolution with " << kernel.rows << "x" << kernel.cols << " kernel via "
+                      << ConvolutionMethodName(ChooseConvolutionMethod(kernel)) << std::endl;
+        }
+        ImageProcessor::applyConvolution(inputImage, dst, kernel);
+    } else if (node.type == OperationType::Noise) {
+        ImageProcessor::applyNoise(inputImage, dst, value, node.seed.value_or(0), origin);
+    } else {
+        // Add other processing node types here...
+        dst.release();
     }
-    return nullptr;
 }
 
-// Recursive function to process the graph ending at nodeId
-// Returns the processed image or an empty Mat on failure
-// Uses a cache to avoid reprocessing nodes within a single "Process" click
-cv::Mat ProcessGraphRecursive(int nodeId, std::map<int, cv::Mat>& cache, std::vector<Node>& nodes, std::vector<Link>& links) {
-    // Check cache first
-    if (cache.count(nodeId)) {
-        return cache[nodeId];
+// Runs a processing step (single node or fused point operations) on its input
+static void ApplyStepOperation(const PlanStep& step, const cv::Mat& inputImage, cv::Mat& dst, bool verbose = true, double scale = 1.0,
+                               cv::Point origin = cv::Point()) {
+    if (step.fusedNodes.empty()) {
+        ApplyNodeOperation(*step.node, inputImage, dst, verbose, scale, origin);
+        return;
     }
 
-    Node* currentNode = FindNodeById(nodeId, nodes);
-    if (!currentNode) {
-        std::cerr << "Error: Node not found during processing: " << nodeId << std::endl;
-        return cv::Mat(); // Return empty Mat on error
+    std::vector<PointOp> ops;
+    for (const Node* fused : step.fusedNodes) ops.push_back(ToPointOp(*fused));
+    ImageProcessor::applyPointOps(inputImage, dst, ops);
+}
+
+// Cache key of a step's result, fused steps chain the keys of their nodes so they match the unfused ones
+static uint64_t StepCacheKey(const PlanStep& step, uint64_t inputKey) {
+    if (step.fusedNodes.empty()) return ComputeCacheKey(*step.node, inputKey);
+
+    uint64_t key = inputKey;
+    for (const Node* fused : step.fusedNodes) key = ComputeCacheKey(*fused, key);
+    return key;
+}
+
+// Content key of a step's result, fused steps chain their nodes' keys like StepCacheKey
+static uint64_t StepContentKey(const PlanStep& step, uint64_t inputContentKey, double scale) {
+    if (step.fusedNodes.empty()) return ComputeContentKey(*step.node, inputContentKey, scale);
+
+    uint64_t key = inputContentKey;
+    for (const Node* fused : step.fusedNodes) key = ComputeContentKey(*fused, key, scale);
+    return key;
+}
+
+// Spatial footprint of a step: how many pixels around an output pixel it reads.
+// -1 if the step cannot run on tiles.
+static int StepHalo(const PlanStep& step) {
+    switch (step.node->type) {
+        case OperationType::Brightness:
+        case OperationType::Contrast:
+        case OperationType::Noise:
+            return 0;
+        case OperationType::Blur:
+            return BlurKernelSize(*step.node, false) / 2;
+        case OperationType::Convolution: {
+            cv::Mat kernel;
+            if (!ConvolutionKernel(*step.node, kernel, false)) return -1;
+            return std::max(kernel.rows, kernel.cols) / 2;
+        }
+        default:
+            return -1;
+    }
+}
+
+// Bookkeeping that travels with each step's image during a run
+struct StepState {
+    uint64_t key = 0;    // Cache key of the result, 0 if the step failed
+    uint64_t contentKey = 0; // Disk cache key of the result, 0 when no disk cache is used
+    double scale = 1.0;  // Resolution relative to the full-size source
+    bool cacheHit = false;
+};
+
+// LoadImage result for a run: the loaded image itself, or a downscaled proxy in preview mode.
+// The loaded image is shared, not copied; steps never write into a buffer someone else holds.
+static cv::Mat SourceImage(const cv::Mat& loaded, const EvalOptions& options, double& scale) {
+    scale = 1.0;
+    int longestSide = std::max(loaded.cols, loaded.rows);
+    if (options.previewMaxSize <= 0 || longestSide <= options.previewMaxSize) {
+        return loaded;
     }
 
+    scale = static_cast<double>(options.previewMaxSize) / longestSide;
+    cv::Size proxySize(std::max(1, static_cast<int>(loaded.cols * scale + 0.5)),
+                       std::max(1, static_cast<int>(loaded.rows * scale + 0.5)));
+    cv::Mat proxy = MatPool::shared().acquire(proxySize, loaded.type());
+    cv::resize(loaded, proxy, proxySize, 0, 0, cv::INTER_AREA);
+    return proxy;
+}
+
+// True if step is the only reader of its input and the input is not a requested
+// result, so a point operation may overwrite the input instead of allocating
+static bool InputIsDeadAfter(const ExecutionPlan& plan, const PlanStep& step) {
+    if (step.inputStep == -1) return false;
+    const PlanStep& producer = plan.steps[step.inputStep];
+    return producer.consumerCount == 1 && !producer.isTarget;
+}
+
+// Evaluates a single step whose producer (if any) already ran
+// Results are reused from the cache while the node and its upstream are unchanged
+// With overwriteInput, point operations run in place when nothing else shares the input buffer
+static bool IsSourceType(OperationType type) {
+    return type == OperationType::LoadImage || type == OperationType::SequenceSource;
+}
+
+static cv::Mat ExecuteStep(const PlanStep& step, cv::Mat* inputImage, const StepState& input, bool overwriteInput,
+                           EvalCache& cache, const EvalOptions& options, StepState& state) {
+    Node* currentNode = step.node;
+    std::optional<cv::Mat>& loadedImage = step.images->loadedCvImage;
+    int nodeId = currentNode->id;
     cv::Mat resultImage;
+    uint64_t resultKey = 0;
+    uint64_t inputKey = input.key;
+    state = StepState();
 
     switch (currentNode->type) {
         case OperationType::LoadImage:
+        case OperationType::SequenceSource: // The frame picked in the editor, value holds its index
             if (currentNode->imagePath.has_value() && !currentNode->imagePath.value().empty()) {
-                // Use the already loaded image if available and path matches, otherwise load
-                // Note: This assumes LoadImage nodes load when path changes.
-                // If not, loading needs to happen here explicitly.
-                if (!currentNode->loadedCvImage.has_value()) {
-                std::cout << "Processing: Loading image for node " << nodeId << std::endl;
-                    currentNode->loadedCvImage = ImageProcessor::loadImage(currentNode->imagePath.value());
+                // Seeding with the proxy size keeps preview and full-resolution results apart
+                resultKey = StepCacheKey(step, static_cast<uint64_t>(std::max(0, options.previewMaxSize)));
+                if (cache.Lookup(nodeId, CacheResolution(options), resultKey, resultImage, &state.contentKey)) {
+                    state.key = resultKey;
+                    state.cacheHit = true;
+                    if (options.diskCache && state.contentKey == 0) {
+                        // Cached before the disk cache was switched on, hash it once now
+                        state.contentKey = SourceContentKey(resultImage);
+                        cache.Store(nodeId, CacheResolution(options), resultKey, resultImage, state.contentKey);
+                    }
+                    int fullWidth = step.images->sourceSize.width;
+                    if (loadedImage.has_value() && !loadedImage.value().empty()) fullWidth = loadedImage.value().cols;
+                    if (fullWidth > 0) state.scale = static_cast<double>(resultImage.cols) / fullWidth;
+                    return resultImage;
                 }
 
-                if (currentNode->loadedCvImage.has_value()) {
-                    resultImage = currentNode->loadedCvImage.value().clone(); // Clone to avoid modifying cache
+                // Neither decode in memory (not loaded yet, or evicted by the memory
+                // budget): decode here, reduced if a preview is all this run needs
+                std::optional<cv::Mat>& reducedImage = step.images->reducedCvImage;
+                if (!loadedImage.has_value() && !(options.previewMaxSize > 0 && reducedImage.has_value() && !reducedImage.value().empty())) {
+                    std::cout << "Processing: Loading image for node " << nodeId << std::endl;
+                    int frame = currentNode->type == OperationType::SequenceSource ? static_cast<int>(currentNode->value.value_or(0.0f)) : -1;
+                    DecodedImage decoded = ImageLoader::Decode(currentNode->imagePath.value(), std::max(0, options.previewMaxSize), frame);
+                    step.images->sourceSize = decoded.fullSize;
+                    if (decoded.reduction > 1) {
+                        reducedImage = decoded.image;
+                    } else {
+                        loadedImage = decoded.image;
+                    }
+                }
+
+                // A reduced decode covers previews without reading the full-resolution file
+                if (options.previewMaxSize > 0 && !loadedImage.has_value() && reducedImage.has_value() &&
+                    !reducedImage.value().empty() && step.images->sourceSize.width > 0) {
+                    resultImage = SourceImage(reducedImage.value(), options, state.scale);
+                    state.scale *= static_cast<double>(reducedImage.value().cols) / step.images->sourceSize.width;
+                    break;
+                }
+
+                if (loadedImage.has_value() && !loadedImage.value().empty()) {
+                    resultImage = SourceImage(loadedImage.value(), options, state.scale);
                     // After resultImage = inputImage.clone();
                     //currentNode->processedImage = resultImage.clone();
 
@@ -70,58 +594,76 @@ cv::Mat ProcessGraphRecursive(int nodeId, std::map<int, cv::Mat>& cache, std::ve
                     resultImage = cv::Mat();
                 }
             } else {
-                std::cerr << "Error: No image path for LoadImage node " << nodeId << std::endl;
+                std::cerr << "Error: No image path for source node " << nodeId << std::endl;
                 resultImage = cv::Mat();
             }
             break;
 
         case OperationType::Brightness:
+        case OperationType::Contrast:
         case OperationType::Blur:
-            // --- Process Ancestor Node(s) ---
-            {
-                const Link* inputLink = FindLinkConnectedToInput(currentNode->inputSlotId, links);
-                if (!inputLink) {
-                    std::cerr << "Error: Input node " << nodeId << " is not connected." << std::endl;
-                    resultImage = cv::Mat();
-                    break; // Exit switch case
-                }
+        case OperationType::Convolution:
+        case OperationType::Noise:
+            if (step.inputStep == -1) {
+                std::cerr << "Error: Input node " << nodeId << " is not connected." << std::endl;
+                resultImage = cv::Mat();
+                break;
+            }
 
-                Node* prevNode = FindNodeByOutputAttr(inputLink->fromSlot, nodes);
-                if (!prevNode) {
-                    std::cerr << "Error: Could not find node connected to input of " << nodeId << std::endl;
-                    resultImage = cv::Mat();
-                    break; // Exit switch case
-                }
+            if (!inputImage || inputImage->empty()) {
+                std::cerr << "Error: Input image for node " << nodeId << " is empty." << std::endl;
+                resultImage = cv::Mat(); // Propagate error
+                break;
+            }
 
-                // Recursively process the previous node
-                cv::Mat inputImage = ProcessGraphRecursive(prevNode->id, cache, nodes, links);
+            {
+                // Skip the operation if neither this node nor anything upstream changed
+                resultKey = StepCacheKey(step, inputKey);
+                state.scale = input.scale;
+                if (options.diskCache) state.contentKey = StepContentKey(step, input.contentKey, input.scale);
+                if (cache.Lookup(nodeId, CacheResolution(options), resultKey, resultImage)) {
+                    std::cout << "Processing: Reusing cached result for node " << nodeId << " (" << currentNode->name << ")" << std::endl;
+                    state.key = resultKey;
+                    state.cacheHit = true;
+                    return resultImage;
+                }
 
-                if (inputImage.empty()) {
-                    std::cerr << "Error: Input image for node " << nodeId << " is empty." << std::endl;
-                    resultImage = cv::Mat(); // Propagate error
-                } else {
-                    // --- Apply Current Node's Operation ---
-                    std::cout << "Processing: Applying operation for node " << nodeId << " (" << currentNode->name << ")" << std::endl;
-                    float value = currentNode->value.value_or(0.0f); // Get value safely
-
-                    if (currentNode->type == OperationType::Brightness) {
-                        resultImage = ImageProcessor::applyBrightness(inputImage, static_cast<int>(value)); // Assuming value is brightness offset
-                    } else if (currentNode->type == OperationType::Blur) {
-                        int kernelSize = static_cast<int>(value);
-                        if (kernelSize <= 0 || kernelSize % 2 == 0) {
-                            kernelSize = 3; // Default to 3 if value is invalid
-                            std::cerr << "Warning: Invalid blur kernel size (" << value << ") for node " << nodeId << ". Using 3." << std::endl;
+                // Then for the same work done in an earlier session or batch run
+                if (options.diskCache && state.contentKey != 0) {
+                    if (options.diskCache->Lookup(state.contentKey, resultImage)) {
+                        std::cout << "Processing: Reusing disk-cached result for node " << nodeId << " (" << currentNode->name << ")" << std::endl;
+                        state.key = resultKey;
+                        state.cacheHit = true;
+                        if (options.cacheIntermediates || step.isTarget || step.consumerCount > 1) {
+                            cache.Store(nodeId, CacheResolution(options), resultKey, resultImage, state.contentKey);
                         }
-                        resultImage = ImageProcessor::applyBlur(inputImage, kernelSize);
+                        return resultImage;
                     }
-                    // Add other processing node types here...
                 }
             }
+
+            // --- Apply Current Node's Operation ---
+            if (!step.fusedNodes.empty()) {
+                std::cout << "Processing: Applying fused point operations for nodes";
+                for (const Node* fused : step.fusedNodes) std::cout << " " << fused->id;
+                std::cout << std::endl;
+            } else {
+                std::cout << "Processing: Applying operation for node " << nodeId << " (" << currentNode->name << ")" << std::endl;
+            }
+            // A dead input buffer we own alone (not cached, not a loaded image) becomes the output
+            if (overwriteInput && WritesInPlace(currentNode->type) && inputImage->u && inputImage->u->refcount == 1) {
+                resultImage = *inputImage;
+            } else {
+                // Every processing step keeps its input's size and type, so a recycled buffer fits
+                resultImage = MatPool::shared().acquire(inputImage->size(), inputImage->type());
+            }
+            ApplyStepOperation(step, *inputImage, resultImage, true, input.scale);
             break;
 
         case OperationType::ProcessDisplay:
-            // Should not be called directly on ProcessDisplay node in this recursive function
-            std::cerr << "Error: ProcessGraphRecursive called on ProcessDisplay node " << nodeId << std::endl;
+        case OperationType::SequenceSink:
+            // Display and output nodes only consume results, they are never part of a plan's steps
+            std::cerr << "Error: ProcessGraph called on output node " << nodeId << std::endl;
             resultImage = cv::Mat();
             break;
 
@@ -129,10 +671,417 @@ cv::Mat ProcessGraphRecursive(int nodeId, std::map<int, cv::Mat>& cache, std::ve
             std::cerr << "Error: Unknown node type encountered during processing: " << static_cast<int>(currentNode->type) << std::endl;
             resultImage = cv::Mat();
             break;
-
     }
 
-    // Store result in cache before returning
-    cache[nodeId] = resultImage;
+    // Store result in cache before returning, failures are never cached
+    // Without cacheIntermediates only results worth keeping are pinned, the rest go back to the pool
+    if (resultImage.empty()) {
+        cache.Erase(nodeId, CacheResolution(options));
+        state.contentKey = 0;
+    } else {
+        if (options.diskCache && IsSourceType(currentNode->type)) {
+            state.contentKey = SourceContentKey(resultImage);
+        }
+        if (options.cacheIntermediates || step.isTarget || step.consumerCount > 1) {
+            cache.Store(nodeId, CacheResolution(options), resultKey, resultImage, state.contentKey);
+        }
+        // Sources are on disk already; chain intermediates would cost more writes than they save
+        if (options.diskCache && state.contentKey != 0 && !IsSourceType(currentNode->type) &&
+            (step.isTarget || step.consumerCount > 1)) {
+            options.diskCache->Store(state.contentKey, resultImage);
+        }
+        state.key = resultKey;
+    }
     return resultImage;
-}
\ No newline at end of file
+}
+
+cv::Mat ApplyPlanStep(const PlanStep& step, cv::Mat& input) {
+    if (input.empty() || step.inputStep == -1) return cv::Mat();
+    cv::Mat output;
+    if (WritesInPlace(step.node->type) && input.u && input.u->refcount == 1) {
+        output = input;
+    } else {
+        output = MatPool::shared().acquire(input.size(), input.type());
+    }
+    ApplyStepOperation(step, input, output, false);
+    MatPool::shared().release(input);
+    return output;
+}
+
+// Ids of the nodes a step computes, for profiling
+static std::vector<int> StepNodeIds(const PlanStep& step) {
+    if (step.fusedNodes.empty()) return {step.node->id};
+    std::vector<int> ids;
+    for (const Node* fused : step.fusedNodes) ids.push_back(fused->id);
+    return ids;
+}
+
+// ExecuteStep, recorded in the run's profile when profiling is on
+static cv::Mat ProfiledExecuteStep(const PlanStep& step, cv::Mat* inputImage, const StepState& input, bool overwriteInput,
+                                   EvalCache& cache, const EvalOptions& options, StepState& state) {
+    if (!options.profile) return ExecuteStep(step, inputImage, input, overwriteInput, cache, options, state);
+
+    EvalProfile::Clock::time_point start = EvalProfile::Clock::now();
+    uint64_t allocatedBefore = MatPool::threadAllocatedBytes();
+    cv::Mat result = ExecuteStep(step, inputImage, input, overwriteInput, cache, options, state);
+
+    NodeProfile profile;
+    profile.resultBytesAllocated = MatPool::threadAllocatedBytes() - allocatedBefore;
+    profile.width = result.cols;
+    profile.height = result.rows;
+    profile.cacheHit = state.cacheHit;
+    options.profile->RecordStep(StepNodeIds(step), step.node->name + " #" + std::to_string(step.node->id), start, profile);
+    return result;
+}
+
+static bool IsCancelled(const EvalOptions& options) {
+    return options.progress && options.progress->cancelled;
+}
+
+static void AddWorkItems(const EvalOptions& options, int count) {
+    if (options.progress) options.progress->totalItems += count;
+}
+
+static void CompleteWorkItem(const EvalOptions& options) {
+    if (options.progress) options.progress->completedItems++;
+}
+
+// Frees step results as soon as their last consumer ran and tracks how many
+// image bytes the run holds at once
+struct ResultLifetimes {
+    std::vector<int> remainingConsumers;
+    int64_t liveBytes = 0;
+    int64_t peakBytes = 0;
+
+    explicit ResultLifetimes(const ExecutionPlan& plan) {
+        for (const PlanStep& step : plan.steps) remainingConsumers.push_back(step.consumerCount);
+    }
+
+    // Call once results[index] is computed, releases its input if this step was the last reader
+    void StepFinished(const ExecutionPlan& plan, std::vector<cv::Mat>& results, int index) {
+        int input = plan.steps[index].inputStep;
+        bool inPlace = input != -1 && results[input].data && results[input].data == results[index].data;
+        if (!inPlace) liveBytes += static_cast<int64_t>(ImageBytes(results[index]));
+        peakBytes = std::max(peakBytes, liveBytes);
+
+        if (input == -1 || --remainingConsumers[input] > 0 || plan.steps[input].isTarget) return;
+        if (!inPlace) liveBytes -= static_cast<int64_t>(ImageBytes(results[input]));
+        MatPool::shared().release(results[input]);
+    }
+
+    void Report(const EvalOptions& options, size_t steps) const {
+        if (options.stats) {
+            // Several runs may share the stats, keep the largest peak
+            int64_t previous = options.stats->peakBytes;
+            while (previous < peakBytes && !options.stats->peakBytes.compare_exchange_weak(previous, peakBytes)) {}
+            options.stats->stepsRun += static_cast<int>(steps);
+        }
+        std::cout << "Processing: Peak image memory " << (peakBytes >> 10) << " KB over " << steps << " steps" << std::endl;
+    }
+};
+
+// Shared state of one parallel plan execution
+struct PlanRun {
+    const ExecutionPlan& plan;
+    EvalCache& cache;
+    std::vector<cv::Mat>& results;
+    const EvalOptions& options;
+    std::vector<StepState> states;
+    std::vector<std::vector<int>> consumers; // Steps fed by each step
+    ResultLifetimes lifetimes;               // Guarded by mutex
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::vector<int> ready;  // Steps whose input is available but which were not dispatched yet
+    int running = 0;
+    int limit = 1;
+    size_t completed = 0;
+
+    PlanRun(const ExecutionPlan& p, EvalCache& c, std::vector<cv::Mat>& r, const EvalOptions& o)
+        : plan(p), cache(c), results(r), options(o), lifetimes(p) {}
+};
+
+static void DispatchReadySteps(PlanRun& run, std::unique_lock<std::mutex>& lock);
+
+static void RunStep(PlanRun& run, int index) {
+    const PlanStep& step = run.plan.steps[index];
+    cv::Mat* inputImage = step.inputStep != -1 ? &run.results[step.inputStep] : nullptr;
+    const StepState& input = step.inputStep != -1 ? run.states[step.inputStep] : StepState();
+    if (!IsCancelled(run.options)) {
+        run.results[index] = ProfiledExecuteStep(step, inputImage, input, InputIsDeadAfter(run.plan, step),
+                                                 run.cache, run.options, run.states[index]);
+    }
+    CompleteWorkItem(run.options);
+
+    // Consumers only depend on this step, so they are all ready now
+    std::unique_lock<std::mutex> lock(run.mutex);
+    run.running--;
+    run.completed++;
+    run.lifetimes.StepFinished(run.plan, run.results, index);
+    for (int consumer : run.consumers[index]) run.ready.push_back(consumer);
+    DispatchReadySteps(run, lock);
+    if (run.completed == run.plan.steps.size()) run.finished.notify_all();
+}
+
+// Hands ready steps to the pool while the run is below its concurrency limit
+static void DispatchReadySteps(PlanRun& run, std::unique_lock<std::mutex>& lock) {
+    (void)lock;
+    while (!run.ready.empty() && run.running < run.limit) {
+        int index = run.ready.back();
+        run.ready.pop_back();
+        run.running++;
+        ThreadPool::shared().submit([&run, index]() { RunStep(run, index); });
+    }
+}
+
+bool ExecutePlan(const ExecutionPlan& plan, EvalCache& cache, std::vector<cv::Mat>& results, const EvalOptions& options) {
+    if (!plan.valid) return false;
+
+    results.assign(plan.steps.size(), cv::Mat());
+    if (plan.steps.empty()) return true;
+    AddWorkItems(options, static_cast<int>(plan.steps.size()));
+
+    ThreadPool& pool = ThreadPool::shared();
+    int limit = options.maxConcurrency > 0 ? options.maxConcurrency : static_cast<int>(pool.size());
+
+    if (limit == 1) {
+        // Steps are topologically sorted, so every producer has run before its consumers
+        std::vector<StepState> states(plan.steps.size());
+        ResultLifetimes lifetimes(plan);
+        for (size_t i = 0; i < plan.steps.size(); i++) {
+            const PlanStep& step = plan.steps[i];
+            cv::Mat* inputImage = step.inputStep != -1 ? &results[step.inputStep] : nullptr;
+            const StepState& input = step.inputStep != -1 ? states[step.inputStep] : StepState();
+            if (IsCancelled(options)) return false;
+            results[i] = ProfiledExecuteStep(step, inputImage, input, InputIsDeadAfter(plan, step), cache, options, states[i]);
+            lifetimes.StepFinished(plan, results, static_cast<int>(i));
+            CompleteWorkItem(options);
+        }
+        lifetimes.Report(options, plan.steps.size());
+        return true;
+    }
+
+    PlanRun run(plan, cache, results, options);
+    run.states.resize(plan.steps.size());
+    run.consumers.resize(plan.steps.size());
+    run.limit = limit;
+    for (size_t i = 0; i < plan.steps.size(); i++) {
+        if (plan.steps[i].inputStep == -1) run.ready.push_back(static_cast<int>(i));
+        else run.consumers[plan.steps[i].inputStep].push_back(static_cast<int>(i));
+    }
+
+    std::unique_lock<std::mutex> lock(run.mutex);
+    DispatchReadySteps(run, lock);
+
+    // Help the pool instead of idling, this also keeps nested runs from starving it
+    while (run.completed < plan.steps.size()) {
+        lock.unlock();
+        bool ranTask = pool.runPendingTask();
+        lock.lock();
+        if (!ranTask && run.completed < plan.steps.size()) {
+            run.finished.wait_for(lock, std::chrono::milliseconds(1));
+        }
+    }
+    if (IsCancelled(options)) return false;
+    run.lifetimes.Report(options, plan.steps.size());
+    return true;
+}
+
+// Computes the target of a LoadImage -> ... -> target chain tile by tile.
+// Returns false (without touching output) if the chain cannot be tiled.
+static bool ExecuteTargetTiled(const ExecutionPlan& plan, int targetStep, EvalCache& cache, const EvalOptions& options, cv::Mat& output) {
+    // Chain from the source to the target
+    std::vector<int> chain;
+    for (int i = targetStep; i != -1; i = plan.steps[i].inputStep) chain.push_back(i);
+    std::reverse(chain.begin(), chain.end());
+
+    Node* source = plan.steps[chain[0]].node;
+    if (chain.size() < 2 || source->type != OperationType::LoadImage) return false;
+    if (!source->imagePath.has_value() || source->imagePath.value().empty()) return false;
+
+    // The input has to be grown by the footprints of every step after the source
+    int totalHalo = 0;
+    for (size_t i = 1; i < chain.size(); i++) {
+        int halo = StepHalo(plan.steps[chain[i]]);
+        if (halo < 0) return false;
+        totalHalo += halo;
+    }
+
+    uint64_t key = 0;
+    for (int index : chain) key = StepCacheKey(plan.steps[index], key);
+    Node* target = plan.steps[targetStep].node;
+    std::string profileName = target->name + " #" + std::to_string(target->id) + " (tiled)";
+    std::vector<int> chainNodeIds;
+    for (size_t i = 1; i < chain.size(); i++) {
+        for (int id : StepNodeIds(plan.steps[chain[i]])) chainNodeIds.push_back(id);
+    }
+    EvalProfile::Clock::time_point start = EvalProfile::Clock::now();
+    NodeProfile profile;
+
+    if (cache.Lookup(target->id, CacheResolution(options), key, output)) {
+        std::cout << "Processing: Reusing cached result for node " << target->id << " (" << target->name << ")" << std::endl;
+        if (options.profile) {
+            profile.width = output.cols;
+            profile.height = output.rows;
+            profile.cacheHit = true;
+            options.profile->RecordStep({target->id}, profileName, start, profile);
+        }
+        return true;
+    }
+
+    std::optional<cv::Mat>& loadedImage = plan.steps[chain[0]].images->loadedCvImage;
+    if (!loadedImage.has_value()) {
+        std::cout << "Processing: Loading image for node " << source->id << std::endl;
+        loadedImage = ImageProcessor::loadImage(source->imagePath.value());
+    }
+    // Read-only from here on, tiles take views into it instead of a full clone
+    const cv::Mat image = loadedImage.value();
+    if (image.empty()) return false;
+
+    // Tiles give the same pixels as whole-image evaluation, so both share disk cache entries
+    uint64_t contentKey = 0;
+    if (options.diskCache) {
+        contentKey = SourceContentKey(image);
+        for (size_t i = 1; i < chain.size(); i++) contentKey = StepContentKey(plan.steps[chain[i]], contentKey, 1.0);
+        if (contentKey != 0 && options.diskCache->Lookup(contentKey, output)) {
+            std::cout << "Processing: Reusing disk-cached result for node " << target->id << " (" << target->name << ")" << std::endl;
+            cache.Store(target->id, CacheResolution(options), key, output, contentKey);
+            if (options.profile) {
+                profile.width = output.cols;
+                profile.height = output.rows;
+                profile.cacheHit = true;
+                options.profile->RecordStep({target->id}, profileName, start, profile);
+            }
+            return true;
+        }
+    }
+
+    int tileSize = options.tileSize;
+    int tilesX = (image.cols + tileSize - 1) / tileSize;
+    int tilesY = (image.rows + tileSize - 1) / tileSize;
+    AddWorkItems(options, tilesX * tilesY);
+    std::cout << "Processing: Tiled evaluation of node " << target->id << " (" << tilesX * tilesY << " tiles of "
+              << tileSize << " px, halo " << totalHalo << " px)" << std::endl;
+
+    // Point operations, blur and fused steps all keep the input's type and size
+    cv::Mat result(image.size(), image.type());
+    const cv::Rect imageRect(0, 0, image.cols, image.rows);
+
+    ThreadPool::shared().parallelFor(static_cast<size_t>(tilesX) * tilesY, [&](size_t tileIndex) {
+        if (IsCancelled(options)) return;
+        EvalProfile::Clock::time_point tileStart = EvalProfile::Clock::now();
+        int tx = static_cast<int>(tileIndex % tilesX);
+        int ty = static_cast<int>(tileIndex / tilesX);
+        cv::Rect tileRect = cv::Rect(tx * tileSize, ty * tileSize, tileSize, tileSize) & imageRect;
+        cv::Rect inputRect = cv::Rect(tileRect.x - totalHalo, tileRect.y - totalHalo,
+                                      tileRect.width + 2 * totalHalo, tileRect.height + 2 * totalHalo) & imageRect;
+
+        // Pixels near the inner edges of the region go stale step by step,
+        // the halo guarantees the tile itself stays exact
+        cv::Mat region = image(inputRect);
+        for (size_t i = 1; i < chain.size(); i++) {
+            cv::Mat next;
+            ApplyStepOperation(plan.steps[chain[i]], region, next, false, 1.0, inputRect.tl());
+            region = next;
+        }
+
+        cv::Rect local(tileRect.x - inputRect.x, tileRect.y - inputRect.y, tileRect.width, tileRect.height);
+        cv::Mat destination = result(tileRect);
+        region(local).copyTo(destination);
+        if (options.profile) {
+            options.profile->RecordSpan("Tile " + std::to_string(tx) + "," + std::to_string(ty), "tile", tileStart);
+        }
+        CompleteWorkItem(options);
+    }, options.maxConcurrency > 0 ? options.maxConcurrency : 0);
+
+    // A cancelled run leaves holes in the result, it must not end up in the cache
+    if (IsCancelled(options)) return true;
+    cache.Store(target->id, CacheResolution(options), key, result, contentKey);
+    if (options.diskCache && contentKey != 0) options.diskCache->Store(contentKey, result);
+    output = result;
+    if (options.profile) {
+        // Every node of the chain ran inside the tiles, they share one measurement
+        profile.resultBytesAllocated = ImageBytes(result);
+        profile.width = result.cols;
+        profile.height = result.rows;
+        profile.fused = true;
+        options.profile->RecordStep(chainNodeIds, profileName, start, profile);
+    }
+    return true;
+}
+
+// Serves a target from the disk cache before anything upstream of it runs.
+// The content key only needs the source, which is loaded (and hashed) here;
+// the in-step lookups of ExecuteStep would find the target only after
+// computing its whole chain. Returns false if the target must be computed,
+// or is in the in-memory cache already.
+static bool LookupTargetOnDisk(const ExecutionPlan& plan, int targetStep, EvalCache& cache, const EvalOptions& options, cv::Mat& output) {
+    std::vector<int> chain;
+    for (int i = targetStep; i != -1; i = plan.steps[i].inputStep) chain.push_back(i);
+    std::reverse(chain.begin(), chain.end());
+    const PlanStep& sourceStep = plan.steps[chain[0]];
+    const PlanStep& targetStepRef = plan.steps[targetStep];
+    if (chain.size() < 2 || sourceStep.node->type != OperationType::LoadImage) return false;
+
+    uint64_t key = StepCacheKey(sourceStep, static_cast<uint64_t>(std::max(0, options.previewMaxSize)));
+    for (size_t i = 1; i < chain.size(); i++) key = StepCacheKey(plan.steps[chain[i]], key);
+    cv::Mat cached;
+    if (cache.Lookup(targetStepRef.node->id, CacheResolution(options), key, cached)) return false;
+
+    EvalProfile::Clock::time_point start = EvalProfile::Clock::now();
+    StepState sourceState;
+    cv::Mat source = ExecuteStep(sourceStep, nullptr, StepState(), false, cache, options, sourceState);
+    if (source.empty() || sourceState.contentKey == 0) return false;
+    uint64_t contentKey = sourceState.contentKey;
+    for (size_t i = 1; i < chain.size(); i++) contentKey = StepContentKey(plan.steps[chain[i]], contentKey, sourceState.scale);
+    if (contentKey == 0 || !options.diskCache->Lookup(contentKey, output)) return false;
+
+    std::cout << "Processing: Reusing disk-cached result for node " << targetStepRef.node->id << " (" << targetStepRef.node->name << ")" << std::endl;
+    cache.Store(targetStepRef.node->id, CacheResolution(options), key, output, contentKey);
+    if (options.profile) {
+        NodeProfile profile;
+        profile.width = output.cols;
+        profile.height = output.rows;
+        profile.cacheHit = true;
+        options.profile->RecordStep({targetStepRef.node->id}, targetStepRef.node->name + " #" + std::to_string(targetStepRef.node->id), start, profile);
+    }
+    return true;
+}
+
+cv::Mat ProcessGraph(int nodeId, EvalCache& cache, NodeStore& nodes, std::vector<Link>& links, const EvalOptions& options) {
+    std::vector<cv::Mat> outputs;
+    if (!ProcessGraphTargets({nodeId}, cache, nodes, links, outputs, options)) return cv::Mat();
+    return outputs[0];
+}
+
+bool ProcessGraphTargets(const std::vector<int>& targetIds, EvalCache& cache, NodeStore& nodes, std::vector<Link>& links,
+                         std::vector<cv::Mat>& outputs, const EvalOptions& options) {
+    outputs.assign(targetIds.size(), cv::Mat());
+
+    ExecutionPlan plan = CompileGraph(targetIds, nodes, links);
+    if (!plan.valid) {
+        std::cerr << "Error: " << plan.error << std::endl;
+        return false;
+    }
+
+    // Targets found on disk and tiled targets are done, only the remaining ones need the whole-image plan
+    std::vector<int> remainingTargets;
+    std::vector<size_t> remainingOutputs;
+    for (size_t i = 0; i < targetIds.size(); i++) {
+        if (options.diskCache && LookupTargetOnDisk(plan, plan.targetSteps[i], cache, options, outputs[i])) continue;
+        bool tileable = options.tileSize > 0 && options.previewMaxSize <= 0; // Proxies are small already
+        if (tileable && ExecuteTargetTiled(plan, plan.targetSteps[i], cache, options, outputs[i])) continue;
+        remainingTargets.push_back(targetIds[i]);
+        remainingOutputs.push_back(i);
+    }
+    if (IsCancelled(options)) return false;
+    if (remainingTargets.empty()) return true;
+    if (remainingTargets.size() != targetIds.size()) plan = CompileGraph(remainingTargets, nodes, links);
+
+    std::vector<cv::Mat> results;
+    if (!ExecutePlan(plan, cache, results, options)) return false;
+    for (size_t i = 0; i < remainingTargets.size(); i++) {
+        outputs[remainingOutputs[i]] = results[plan.targetSteps[i]];
+    }
+    return true;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "_Node.h"
+#include "NodeStore.h"
+#include "DiskCache.h"
+#include "MemoryManager.h"
+#include "Profiler.h"
+
+// Graph lookup helpers
+Node* FindNodeById(int nodeId, NodeStore& nodes);
+const Link* FindLinkConnectedToInput(int inputAttrId, std::vector<Link>& links);
+Node* FindNodeByOutputAttr(int outputAttrId, NodeStore& nodes);
+
+// Ids of nodeId and every node downstream of it
+std::vector<int> CollectDownstreamNodes(int nodeId, NodeStore& nodes, std::vector<Link>& links);
+
+// Result of a node from an earlier evaluation. The key hashes the node's
+// parameters together with the key of its upstream result, so an entry is
+// only reused while nothing it depends on has changed.
+struct CacheEntry {
+    uint64_t key = 0;
+    cv::Mat image;
+    uint64_t contentKey = 0; // Session-independent key of the same result, see DiskCache
+};
+
+// Per-node results kept across "Process Graph" clicks
+// Safe to use from the parallel executor's worker threads
+// A node keeps a preview and a full-resolution result side by side, so a Full
+// Res or Save Image run does not evict the preview the editor goes back to.
+struct EvalCache {
+    enum class Resolution { Full, Preview };
+    std::map<int, CacheEntry> entries[2]; // Indexed by Resolution, keyed by node id
+    std::mutex mutex;
+    MemoryManager* memory = nullptr; // Optional, entries then count against its budget as CachedResult or CachedPreview
+
+    // Returns true and the cached image if nodeId has an entry for key
+    bool Lookup(int nodeId, Resolution resolution, uint64_t key, cv::Mat& image, uint64_t* contentKey = nullptr);
+    void Store(int nodeId, Resolution resolution, uint64_t key, const cv::Mat& image, uint64_t contentKey = 0);
+    void Erase(int nodeId, Resolution resolution);
+
+    // Drops both entries of nodeId and every node downstream of it
+    void Invalidate(int nodeId, NodeStore& nodes, std::vector<Link>& links);
+    void Clear();
+};
+
+// Progress of a running evaluation, shared with the thread that started it.
+// Work items are plan steps, or tiles for tiled targets.
+struct EvalProgress {
+    std::atomic<bool> cancelled{false}; // Set to stop the run, remaining work is skipped
+    std::atomic<int> completedItems{0};
+    std::atomic<int> totalItems{0};
+
+    float Fraction() const {
+        int total = totalItems;
+        return total > 0 ? static_cast<float>(completedItems) / total : 0.0f;
+    }
+};
+
+// Memory use of a run, filled in by ExecutePlan
+struct EvalStats {
+    std::atomic<int64_t> peakBytes{0};  // Most image bytes the run held at once
+    std::atomic<int> stepsRun{0};
+};
+
+// Per-run evaluation settings
+struct EvalOptions {
+    int maxConcurrency = 0; // Upper bound on nodes running at once, 0 = every pool thread, 1 = serial
+    int tileSize = 0;       // > 0 evaluates chains tile by tile (tileSize x tileSize) to bound peak memory
+    int previewMaxSize = 0; // > 0 evaluates on LoadImage proxies no longer than this on either side,
+                            // resolution-dependent parameters (blur kernels) are scaled to match
+    bool cacheIntermediates = true; // false caches only targets and shared results, so chain
+                                    // intermediates can be recycled as soon as they are dead
+    EvalProgress* progress = nullptr; // Optional progress reporting and cancellation
+    EvalStats* stats = nullptr;       // Optional memory statistics
+    EvalProfile* profile = nullptr;   // Optional per-node timings and trace
+    DiskCache* diskCache = nullptr;   // Optional persistent cache, consulted after the in-memory one.
+                                      // Targets and results read by several steps are written to it.
+};
+
+// Cache slot of the results a run with these options produces
+EvalCache::Resolution CacheResolution(const EvalOptions& options);
+
+// Hash index over the links so lookups during compilation are O(1), NodeStore indexes the nodes itself
+struct GraphIndex {
+    std::unordered_map<int, const Link*> linkByInputSlot;
+};
+
+GraphIndex BuildGraphIndex(std::vector<Link>& links);
+
+// One node of a compiled plan
+struct PlanStep {
+    Node* node = nullptr;
+    NodeImages* images = nullptr; // node's payload in the store the plan was compiled from
+    int inputStep = -1; // Index of the producing step, -1 if the input is unconnected or the node is a source
+
+    // Consecutive point operations (Brightness/Contrast) folded into this step,
+    // in application order and ending with node. Empty for unfused steps.
+    std::vector<Node*> fusedNodes;
+
+    // Filled in by the memory planner, the result is freed once all consumers ran
+    int consumerCount = 0;  // Steps reading this step's result
+    bool isTarget = false;  // Requested result, kept until the run returns
+};
+
+// Flat, topologically sorted list of the nodes needed for a set of targets
+struct ExecutionPlan {
+    std::vector<PlanStep> steps;    // Producers always come before their consumers
+    std::vector<int> targetSteps;   // Step index of each requested target, in request order
+    bool valid = false;
+    std::string error;              // Set when compilation fails (missing node, cycle)
+};
+
+// Collects every node the targets depend on, rejects cyclic graphs
+// Runs of point operations whose intermediates nobody else reads are fused into single steps
+// The plan points into nodes/links, so it is invalidated by adding or removing nodes
+ExecutionPlan CompileGraph(const std::vector<int>& targetIds, NodeStore& nodes, std::vector<Link>& links);
+
+// Runs the plan, results[i] holds the image of plan.steps[i] if it is a target (empty on failure)
+// Intermediate results are released to the MatPool once their last consumer ran,
+// so their entries are empty when the call returns
+// Returns false if the plan is invalid or the run was cancelled
+// Each step is dispatched to the shared thread pool as soon as its input is ready,
+// so independent branches run concurrently
+bool ExecutePlan(const ExecutionPlan& plan, EvalCache& cache, std::vector<cv::Mat>& results, const EvalOptions& options = EvalOptions());
+
+// Runs a processing step of a plan on one full-resolution image, for callers
+// streaming frames through a plan instead of running it with ExecutePlan.
+// input's buffer becomes the output when nothing else shares it and the step
+// can run in place; input is empty afterwards. Empty on failure.
+cv::Mat ApplyPlanStep(const PlanStep& step, cv::Mat& input);
+
+// Compiles and runs the graph ending at nodeId, returns an empty Mat on failure
+// Only nodes whose parameters or upstream changed since the last call are recomputed
+cv::Mat ProcessGraph(int nodeId, EvalCache& cache, NodeStore& nodes, std::vector<Link>& links, const EvalOptions& options = EvalOptions());
+
+// Same for several targets at once, shared upstream nodes run only once
+// outputs[i] receives the result of targetIds[i], returns false on compile errors or cancellation
+// With options.tileSize set, targets whose chain only has nodes with a known
+// spatial footprint are computed tile by tile in parallel, each tile reading
+// its footprint (halo) from the source; only the final image is full size.
+// Other targets fall back to whole-image evaluation.
+bool ProcessGraphTargets(const std::vector<int>& targetIds, EvalCache& cache, NodeStore& nodes, std::vector<Link>& links,
+                         std::vector<cv::Mat>& outputs, const EvalOptions& options = EvalOptions());